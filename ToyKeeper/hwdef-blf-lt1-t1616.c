@@ -52,15 +52,9 @@ Channel channels[] = {
 
 
 void set_level_zero() {
-    // disable timer overflow interrupt
-    // (helps improve button press handling from Off state)
-    DSM_INTCTRL = 0;
+    dsm_stop();
 
     // turn off all LEDs
-    ch1_dsm_lvl = 0;
-    ch2_dsm_lvl = 0;
-    CH1_PWM     = 0;
-    CH2_PWM     = 0;
     PWM_CNT     = 0;
 }
 
@@ -69,51 +63,17 @@ void set_hw_levels(PWM_DATATYPE ch1, PWM_DATATYPE ch2) {
     bool was_on = (CH1_PWM>0) || (CH2_PWM>0);
 
     // set delta-sigma soft levels
-    ch1_dsm_lvl = ch1;
-    ch2_dsm_lvl = ch2;
+    dsm_set(0, ch1);
+    dsm_set(1, ch2);
 
-    // set hardware PWM levels and init dsm loop
-    CH1_PWM = ch1_pwm = ch1 >> 7;
-    CH2_PWM = ch2_pwm = ch2 >> 7;
-
-    // enable timer overflow interrupt so DSM can work
-    DSM_INTCTRL = DSM_OVF_bm;
+    // set hardware PWM levels and start the dsm loop
+    dsm_start();
 
     // reset phase when turning on
     if (! was_on) PWM_CNT = 0;
 
 }
 
-// delta-sigma modulation of PWM outputs
-// happens on each Timer overflow (every 512 cpu clock cycles)
-// uses 8-bit pwm w/ 7-bit dsm (0b 0PPP PPPP PDDD DDDD)
-ISR(DSM_vect) {
-    // set new hardware values first,
-    // for best timing (reduce effect of interrupt jitter)
-    CH1_PWM = ch1_pwm;
-    CH2_PWM = ch2_pwm;
-
-    // calculate next values, now that timing matters less
-
-    // accumulate error
-    ch1_dsm += (ch1_dsm_lvl & 0x007f);
-    // next PWM = base PWM value + carry bit
-    ch1_pwm  = (ch1_dsm_lvl >> 7) + (ch1_dsm > 0x7f);
-    // clear carry bit
-    ch1_dsm &= 0x7f;
-
-    // repeat for other channels
-
-    ch2_dsm += (ch2_dsm_lvl & 0x007f);
-    ch2_pwm  = (ch2_dsm_lvl >> 7) + (ch2_dsm > 0x7f);
-    ch2_dsm &= 0x7f;
-
-    // clear the interrupt flag to indicate it was handled
-    // as per: https://onlinedocs.microchip.com/pr/GUID-C37FFBA8-82C6-4339-A2B1-ABD9A0F6C162-en-US-8/index.html?GUID-C2A2BEFD-158F-413D-B9D4-0F0556AA79BD
-    DSM_INTFLAGS = DSM_OVF_bm;
-}
-
-
 void set_level_ch1(uint8_t level) {
     set_hw_levels(PWM_GET(pwm1_levels, level), 0);
 }
@@ -158,26 +118,9 @@ void set_level_auto(uint8_t level) {
 
 ///// bump each channel toward a target value /////
 bool gradual_adjust(PWM_DATATYPE ch1, PWM_DATATYPE ch2) {
-    // adjust multiple times based on current brightness
-    // (so it adjusts faster/coarser when bright, slower/finer when dim)
-
-    // higher shift = slower/finer adjustments
-    const uint8_t shift = 9;  // ((255 << 7) >> 9) = 63 max
-    uint8_t steps;
-
-    steps = ch1_dsm_lvl >> shift;
-    for (uint8_t i=0; i<=steps; i++)
-        GRADUAL_ADJUST_SIMPLE(ch1, ch1_dsm_lvl);
-
-    steps = ch2_dsm_lvl  >> shift;
-    for (uint8_t i=0; i<=steps; i++)
-        GRADUAL_ADJUST_SIMPLE(ch2, ch2_dsm_lvl);
-
-    if ((ch1 == ch1_dsm_lvl)
-     && (ch2 == ch2_dsm_lvl )) {
-        return true;  // done
-    }
-    return false;  // not done yet
+    // (not "&&", because every channel needs a tick)
+    return dsm_gradual_tick(0, ch1)
+         & dsm_gradual_tick(1, ch2);
 }
 
 bool gradual_tick_ch1(uint8_t gt) {
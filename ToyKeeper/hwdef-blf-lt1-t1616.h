@@ -59,8 +59,12 @@ enum channel_modes_e {
 #define PWM_TOP  TCA0.SINGLE.PERBUF  // holds the TOP value for for variable-resolution PWM
 #define PWM_TOP_INIT  255
 #define PWM_CNT  TCA0.SINGLE.CNT  // for resetting phase after each TOP adjustment
-// (max is (255 << 7), because it's 8-bit PWM plus 7 bits of DSM)
-#define DSM_TOP       (255<<7) // 15-bit resolution leaves 1 bit for carry
+
+// 8-bit PWM plus 7 bits of DSM (max is (255 << 7))
+#define USE_DELTA_SIGMA
+#define DSM_CHANNELS  2
+#define DSM_CH1_PWM   CH1_PWM
+#define DSM_CH2_PWM   CH2_PWM
 
 // timer interrupt for DSM
 #define DSM_vect     TCA0_OVF_vect
@@ -71,14 +75,10 @@ enum channel_modes_e {
 #define DELAY_FACTOR 90  // less time in delay() because more time spent in interrupts
 
 // warm LEDs
-uint16_t ch1_dsm_lvl;
-uint8_t ch1_pwm, ch1_dsm;
 #define CH1_PIN  PB1
 #define CH1_PWM  TCA0.SINGLE.CMP1BUF  // CMP1 is the output compare register for PB1
 
 // cold LEDs
-uint16_t ch2_dsm_lvl;
-uint8_t ch2_pwm, ch2_dsm;
 #define CH2_PIN  PB0
 #define CH2_PWM  TCA0.SINGLE.CMP0BUF  // CMP0 is the output compare register for PB0
 
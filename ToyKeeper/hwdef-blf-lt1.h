@@ -54,7 +54,12 @@ enum channel_modes_e {
 
 // PWM parameters of both channels are tied together because they share a counter
 #define PWM_TOP_INIT  255
-#define DSM_TOP       (255<<7) // 15-bit resolution leaves 1 bit for carry
+
+// 8-bit PWM plus 7 bits of DSM (max is (255 << 7))
+#define USE_DELTA_SIGMA
+#define DSM_CHANNELS  2
+#define DSM_CH1_PWM   CH1_PWM
+#define DSM_CH2_PWM   CH2_PWM
 
 // timer interrupt for DSM
 #define DSM_vect     TIMER0_OVF_vect
@@ -64,14 +69,10 @@ enum channel_modes_e {
 #define DELAY_FACTOR 90  // less time in delay() because more time spent in interrupts
 
 // warm LEDs
-uint16_t ch1_dsm_lvl;
-uint8_t ch1_pwm, ch1_dsm;
 #define CH1_PIN  PB1        // pin 6, warm tint PWM
 #define CH1_PWM  OCR0B      // OCR0B is the output compare register for PB1
 
 // cold LEDs
-uint16_t ch2_dsm_lvl;
-uint8_t ch2_pwm, ch2_dsm;
 #define CH2_PIN  PB0        // pin 5, cold tint PWM
 #define CH2_PWM  OCR0A      // OCR0A is the output compare register for PB0
 
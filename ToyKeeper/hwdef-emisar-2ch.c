@@ -55,40 +55,43 @@ Channel channels[] = {
 // handling any possible combination
 // and any before/after state
 void set_pwms(uint16_t ch1_pwm, uint16_t ch2_pwm, uint16_t top) {
-    bool was_on = (CH1_PWM>0) | (CH2_PWM>0);
-    bool now_on = (ch1_pwm>0) | (ch2_pwm>0);
-
-    if (! now_on) {
-        CH1_PWM = 0;
-        CH2_PWM = 0;
-        PWM_TOP = PWM_TOP_INIT;
-        PWM_CNT = 0;
-        CH1_ENABLE_PORT &= ~(1 << CH1_ENABLE_PIN);  // disable opamp
-        CH2_ENABLE_PORT &= ~(1 << CH2_ENABLE_PIN);  // disable opamp
-        return;
+    // (the whole update, so the TOP interrupt can't land in the middle)
+    PWM_ATOMIC {
+        bool was_on = (CH1_PWM>0) | (CH2_PWM>0);
+        bool now_on = (ch1_pwm>0) | (ch2_pwm>0);
+
+        if (! now_on) {
+            CH1_PWM = 0;
+            CH2_PWM = 0;
+            set_pwm_top_now(PWM_TOP_INIT);
+            PWM_CNT = 0;
+            CH1_ENABLE_PORT &= ~(1 << CH1_ENABLE_PIN);  // disable opamp
+            CH2_ENABLE_PORT &= ~(1 << CH2_ENABLE_PIN);  // disable opamp
+            return;
+        }
+
+        if (ch1_pwm)
+            CH1_ENABLE_PORT |= (1 << CH1_ENABLE_PIN);  // enable opamp
+        else
+            CH1_ENABLE_PORT &= ~(1 << CH1_ENABLE_PIN);  // disable opamp
+
+        if (ch2_pwm)
+            CH2_ENABLE_PORT |= (1 << CH2_ENABLE_PIN);  // enable opamp
+        else
+            CH2_ENABLE_PORT &= ~(1 << CH2_ENABLE_PIN);  // disable opamp
+
+        CH1_PWM = ch1_pwm;
+        CH2_PWM = ch2_pwm;
+
+        if (was_on) {
+            // change TOP at the timer's next TOP, to avoid flashes
+            set_pwm_top(top);
+        } else {
+            // reset phase when turning on
+            set_pwm_top_now(top);
+            PWM_CNT = 0;
+        }
     }
-
-    if (ch1_pwm)
-        CH1_ENABLE_PORT |= (1 << CH1_ENABLE_PIN);  // enable opamp
-    else
-        CH1_ENABLE_PORT &= ~(1 << CH1_ENABLE_PIN);  // disable opamp
-
-    if (ch2_pwm)
-        CH2_ENABLE_PORT |= (1 << CH2_ENABLE_PIN);  // enable opamp
-    else
-        CH2_ENABLE_PORT &= ~(1 << CH2_ENABLE_PIN);  // disable opamp
-
-    CH1_PWM = ch1_pwm;
-    CH2_PWM = ch2_pwm;
-
-    // manual phase sync when changing level while already on
-    if (was_on && now_on) while(PWM_CNT > (top - 32)) {}
-
-    PWM_TOP = top;
-
-    // reset phase when turning on or off
-    //if ((! was_on) | (! now_on)) PWM_CNT = 0;
-    if (! was_on) PWM_CNT = 0;
 }
 
 void set_level_zero() {
@@ -140,15 +143,17 @@ void set_level_auto(uint8_t level) {
 
 ///// bump each channel toward a target value /////
 bool gradual_adjust(uint16_t ch1_pwm, uint16_t ch2_pwm) {
-    GRADUAL_ADJUST_SIMPLE(ch1_pwm, CH1_PWM);
-    GRADUAL_ADJUST_SIMPLE(ch2_pwm, CH2_PWM);
+    bool done;
+
+    PWM_ATOMIC {
+        GRADUAL_ADJUST_SIMPLE(ch1_pwm, CH1_PWM);
+        GRADUAL_ADJUST_SIMPLE(ch2_pwm, CH2_PWM);
 
-    // check for completion
-    if ((ch1_pwm == CH1_PWM)
-     && (ch2_pwm == CH2_PWM)) {
-        return true;  // done
+        // check for completion
+        done = (   (ch1_pwm == CH1_PWM)
+                && (ch2_pwm == CH2_PWM));
     }
-    return false;  // not done yet
+    return done;
 }
 
 bool gradual_tick_ch1(uint8_t gt) {
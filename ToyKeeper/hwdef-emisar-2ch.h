@@ -79,6 +79,12 @@ enum channel_modes_e {
 #define PWM_TOP       ICR1   // holds the TOP value for for variable-resolution PWM
 #define PWM_TOP_INIT  511    // highest value used in top half of ramp
 #define PWM_CNT       TCNT1  // for dynamic PWM, reset phase
+// interrupt at TOP, to change TOP without flashes (see set_pwm_top())
+#define PWM_TOP_vect        TIMER1_CAPT_vect
+#define PWM_TOP_INTCTRL     TIMSK
+#define PWM_TOP_INT_bm      (1<<ICIE1)
+#define PWM_TOP_INTFLAGS    TIFR
+#define PWM_TOP_INTFLAG_bm  (1<<ICF1)
 
 // main LEDs, linear
 #define CH1_PIN  PB3            // pin 16, Opamp reference
@@ -78,26 +78,18 @@ StatePtr channel_3H_modes[NUM_CHANNEL_MODES] = {
 };
 
 void set_level_zero() {
-    // disable timer overflow interrupt
-    // (helps improve button press handling from Off state)
-    DSM_INTCTRL &= ~DSM_OVF_bm;
+    dsm_stop();
 
     // turn off all LEDs
     MAIN2_ENABLE_PORT &= ~(1 << MAIN2_ENABLE_PIN);
     LED3_ENABLE_PORT  &= ~(1 << LED3_ENABLE_PIN );
     LED4_ENABLE_PORT  &= ~(1 << LED4_ENABLE_PIN );
-    main2_dsm_lvl = 0;
-    led3_dsm_lvl  = 0;
-    led4_dsm_lvl  = 0;
-    MAIN2_PWM_LVL = 0;
-    LED3_PWM_LVL  = 0;
-    LED4_PWM_LVL  = 0;
     PWM_CNT       = 0;
     //PWM_TOP       = PWM_TOP_INIT;
 }
 
 // wrap setting the dsm vars, to get a faster response
-// (just setting *_dsm_lvl doesn't work well for strobes)
+// (just setting dsm levels doesn't work well for strobes)
 void set_hw_levels(PWM_DATATYPE main2, // brightness, 0 to DSM_TOP
                    PWM_DATATYPE led3,
                    PWM_DATATYPE led4,
@@ -120,51 +112,16 @@ void set_hw_levels(PWM_DATATYPE main2, // brightness, 0 to DSM_TOP
     else LED4_ENABLE_PORT  &= ~(1 << LED4_ENABLE_PIN);
 
     // set delta-sigma soft levels
-    main2_dsm_lvl = main2;
-    led3_dsm_lvl  = led3;
-    led4_dsm_lvl  = led4;
-    // set hardware PWM levels and init dsm loop
-    MAIN2_PWM_LVL = main2_pwm = main2 >> 7;
-    LED3_PWM_LVL  = led3_pwm  = led3  >> 7;
-    LED4_PWM_LVL  = led4_pwm  = led4  >> 7;
-
-    // enable timer overflow interrupt so DSM can work
-    DSM_INTCTRL |= DSM_OVF_bm;
+    dsm_set(0, main2);
+    dsm_set(1, led3);
+    dsm_set(2, led4);
+    // set hardware PWM levels and start the dsm loop
+    dsm_start();
 
     // force phase reset
     PWM_CNT       = PWM_CNT2  = 0;
 }
 
-// delta-sigma modulation of PWM outputs
-// happens on each Timer overflow (every 512 cpu clock cycles)
-// uses 8-bit pwm w/ 7-bit dsm (0b 0PPP PPPP PDDD DDDD)
-ISR(DSM_vect) {
-    // set new hardware values first,
-    // for best timing (reduce effect of interrupt jitter)
-    MAIN2_PWM_LVL = main2_pwm;
-    LED3_PWM_LVL  = led3_pwm;
-    LED4_PWM_LVL  = led4_pwm;
-
-    // calculate next values, now that timing matters less
-
-    // accumulate error
-    main2_dsm += (main2_dsm_lvl & 0x007f);
-    // next PWM = base PWM value + carry bit
-    main2_pwm  = (main2_dsm_lvl >> 7) + (main2_dsm > 0x7f);
-    // clear carry bit
-    main2_dsm &= 0x7f;
-
-    // repeat for other channels
-
-    led3_dsm += (led3_dsm_lvl & 0x007f);
-    led3_pwm  = (led3_dsm_lvl >> 7) + (led3_dsm > 0x7f);
-    led3_dsm &= 0x7f;
-
-    led4_dsm += (led4_dsm_lvl & 0x007f);
-    led4_pwm  = (led4_dsm_lvl >> 7) + (led4_dsm > 0x7f);
-    led4_dsm &= 0x7f;
-}
-
 // LEDs 1+2 are 8-bit
 // this 8-bit channel may be LEDs 1+2 or LED 4, depending on wiring
 void set_level_main2(uint8_t level) {
@@ -224,42 +181,6 @@ void set_level_hsv(uint8_t level) {
                   0,       0,       0);
 }
 
-// calculate a 3-channel "auto tint" blend
-// (like red -> warm white -> cool white)
-// results are placed in *a, *b, and *c vars
-// level : ramp level to convert into 3 channel levels
-// (assumes ramp table is "pwm1_levels")
-void calc_auto_3ch_blend(
-    PWM_DATATYPE *a,  // red
-    PWM_DATATYPE *b,  // warm
-    PWM_DATATYPE *c,  // cool
-    uint8_t level) {
-
-    PWM_DATATYPE vpwm  = PWM_GET(pwm1_levels, level);
-
-    // tint goes from 0 (red) to 127 (warm white) to 255 (cool white)
-    uint8_t mytint;
-    mytint = 255 * (uint16_t)(level+1) / RAMP_SIZE;
-
-    uint8_t falling=0, rising=0;
-    if (level < (RAMP_SIZE/2))
-        falling = 255 - triangle_wave(mytint);
-    else
-        rising = 255 - triangle_wave(mytint);
-
-    // TODO: make "a" drop to zero sooner, and "c" start ramping up later
-    // red is high at 0, low at 255 (linear)
-    *a = (((PWM_DATATYPE2)falling
-         * (PWM_DATATYPE2)vpwm) + 127) / 255;
-    // warm white is low at 0 and 255, high at 127 (linear triangle)
-    *b = (((PWM_DATATYPE2)triangle_wave(mytint)
-         * (PWM_DATATYPE2)vpwm)      ) / 255;
-    // cool white is low at 0, high at 255 (linear)
-    *c = (((PWM_DATATYPE2)rising
-         * (PWM_DATATYPE2)vpwm) + 127) / 255;
-
-}
-
 // 3-channel "auto tint" channel mode
 void set_level_auto3(uint8_t level) {
     PWM_DATATYPE a, b, c;
@@ -273,31 +194,10 @@ void set_level_auto3(uint8_t level) {
 // (and other smooth adjustments)
 
 bool gradual_adjust(PWM_DATATYPE main2, PWM_DATATYPE led3, PWM_DATATYPE led4) {
-    // adjust multiple times based on current brightness
-    // (so it adjusts faster/coarser when bright, slower/finer when dim)
-
-    // higher shift = slower/finer adjustments
-    const uint8_t shift = 9;  // ((255 << 7) >> 9) = 63 max
-    uint8_t steps;
-
-    steps = main2_dsm_lvl >> shift;
-    for (uint8_t i=0; i<=steps; i++)
-        GRADUAL_ADJUST_SIMPLE(main2, main2_dsm_lvl);
-
-    steps = led3_dsm_lvl  >> shift;
-    for (uint8_t i=0; i<=steps; i++)
-        GRADUAL_ADJUST_SIMPLE(led3,  led3_dsm_lvl );
-
-    steps = led4_dsm_lvl  >> shift;
-    for (uint8_t i=0; i<=steps; i++)
-        GRADUAL_ADJUST_SIMPLE(led4,  led4_dsm_lvl );
-
-    if ((main2 == main2_dsm_lvl)
-     && (led3  == led3_dsm_lvl )
-     && (led4  == led4_dsm_lvl )) {
-        return true;  // done
-    }
-    return false;  // not done yet
+    // (not "&&", because every channel needs a tick)
+    return dsm_gradual_tick(0, main2)
+         & dsm_gradual_tick(1, led3)
+         & dsm_gradual_tick(2, led4);
 }
 
 bool gradual_tick_main2(uint8_t gt) {
@@ -75,6 +75,7 @@ enum channel_modes_e {
 
 // can use some of the common handlers
 #define USE_CALC_2CH_BLEND
+#define USE_CALC_AUTO_3CH_BLEND
 #define USE_HSV2RGB
 
 
@@ -91,8 +92,13 @@ enum channel_modes_e {
 #define PWM_TOP_INIT  255    // highest value used in top half of ramp
 #define PWM_CNT       TCNT1  // for checking / resetting phase
 #define PWM_CNT2      TCNT0  // for checking / resetting phase
-// (max is (255 << 7), because it's 8-bit PWM plus 7 bits of DSM)
-#define DSM_TOP       (255<<7) // 15-bit resolution leaves 1 bit for carry
+
+// 8-bit PWM plus 7 bits of DSM (max is (255 << 7))
+#define USE_DELTA_SIGMA
+#define DSM_CHANNELS  3
+#define DSM_CH1_PWM   MAIN2_PWM_LVL
+#define DSM_CH2_PWM   LED3_PWM_LVL
+#define DSM_CH3_PWM   LED4_PWM_LVL
 
 // timer interrupt for DSM
 #define DSM_vect     TIMER0_OVF_vect
@@ -102,24 +108,18 @@ enum channel_modes_e {
 #define DELAY_FACTOR 90  // less time in delay() because more time spent in interrupts
 
 // main 2 LEDs / 1st channel (2 LEDs)
-uint16_t main2_dsm_lvl;
-uint8_t main2_pwm, main2_dsm;
 #define MAIN2_PWM_PIN PC0
 #define MAIN2_PWM_LVL OCR0A   // OCR0A is the output compare register for PC0
 #define MAIN2_ENABLE_PIN  PB0    // Opamp power
 #define MAIN2_ENABLE_PORT PORTB  // control port for PB0
 
 // LED 3 / 2nd channel (1 LED)
-uint16_t led3_dsm_lvl;
-uint8_t led3_pwm, led3_dsm;
 #define LED3_PWM_PIN PB3
 #define LED3_PWM_LVL OCR1A   // OCR1A is the output compare register for PB3
 #define LED3_ENABLE_PIN  PA1    // Opamp power
 #define LED3_ENABLE_PORT PORTA  // control port for PA1
 
 // LED 4 / 3rd channel (1 LED)
-uint16_t led4_dsm_lvl;
-uint8_t led4_pwm, led4_dsm;
 #define LED4_PWM_PIN PA6
 #define LED4_PWM_LVL OCR1B  // OCR1B is the output compare register for PA6
 #define LED4_ENABLE_PIN  PA0    // Opamp power
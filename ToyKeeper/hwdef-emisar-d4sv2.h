@@ -57,6 +57,7 @@ enum CHANNEL_MODES {
 
 
 #define PWM_CHANNELS 3  // old, remove this
+#define USE_SET_LEVEL_3CH_STACKED  // use common set_level function
 
 #define PWM_BITS      16        // dynamic 16-bit, but never goes over 255
 #define PWM_GET       PWM_GET8
@@ -70,6 +71,12 @@ enum CHANNEL_MODES {
 #define PWM_TOP       ICR1   // holds the TOP value for for variable-resolution PWM
 #define PWM_TOP_INIT  255    // highest value used in top half of ramp
 #define PWM_CNT       TCNT1  // for dynamic PWM, reset phase
+// interrupt at TOP, to change TOP without flashes (see set_pwm_top())
+#define PWM_TOP_vect        TIMER1_CAPT_vect
+#define PWM_TOP_INTCTRL     TIMSK
+#define PWM_TOP_INT_bm      (1<<ICIE1)
+#define PWM_TOP_INTFLAGS    TIFR
+#define PWM_TOP_INTFLAG_bm  (1<<ICF1)
 
 // 1x7135 channel
 #define CH1_PIN  PB3            // pin 16, 1x7135 PWM
@@ -57,6 +57,7 @@ enum CHANNEL_MODES {
 
 
 #define PWM_CHANNELS 2  // old, remove this
+#define USE_SET_LEVEL_2CH_STACKED  // use common set_level function
 
 #define PWM_BITS      16        // dynamic 16-bit, but never goes over 255
 #define PWM_GET       PWM_GET8
@@ -69,6 +70,32 @@ enum CHANNEL_MODES {
 #define PWM_TOP       ICR1   // holds the TOP value for for variable-resolution PWM
 #define PWM_TOP_INIT  255    // highest value used in top half of ramp
 #define PWM_CNT       TCNT1  // for dynamic PWM, reset phase
+// interrupt at TOP, to change TOP without flashes (see set_pwm_top())
+#define PWM_TOP_vect        TIMER1_CAPT_vect
+#define PWM_TOP_INTCTRL     TIMSK
+#define PWM_TOP_INT_bm      (1<<ICIE1)
+#define PWM_TOP_INTFLAGS    TIFR
+#define PWM_TOP_INTFLAG_bm  (1<<ICF1)
+
+// timer0 isn't used for PWM, so it's a 1 kHz clock for delays and
+// animations (see fsm-clock.h)
+#define MS_CLOCK_vect       TIMER0_COMPA_vect
+#define MS_CLOCK_INTCTRL    TIMSK
+#define MS_CLOCK_INT_bm     (1<<OCIE0A)
+// ... and its other compare channel times strobe flashes (see fsm-pulse.h)
+#define PULSE_vect          TIMER0_COMPB_vect
+#define PULSE_INTCTRL       TIMSK
+#define PULSE_INT_bm        (1<<OCIE0B)
+#define PULSE_INTFLAGS      TIFR
+#define PULSE_INTFLAG_bm    (1<<OCF0B)
+#define PULSE_CNT           TCNT0
+#define PULSE_CMP           OCR0B
+#define PULSE_CNT_TOP       125  // OCR0A + 1
+#define PULSE_US_PER_CNT    8    // 8 MHz / 64
+// disconnect the PWM pins, so they go low right away
+// (new PWM values wouldn't take effect until the end of the cycle)
+#define PULSE_CUT()    TCCR1A &= ~((1<<COM1A1) | (1<<COM1B1))
+#define PULSE_UNCUT()  TCCR1A |= (1<<COM1A1) | (1<<COM1B1)
 
 // 1x7135 channel
 #define CH1_PIN  PB3            // pin 16, 1x7135 PWM
@@ -161,6 +188,16 @@ inline void hwdef_setup() {
             ;
     #endif
 
+    // configure ms clock
+    // F_clock = F_clkio / N / (OCR0A+1), where N = prescale factor
+    // (8 MHz / 64 / 125 = 1 kHz)
+    TCCR0A  = (1<<WGM01) | (0<<WGM00)  // CTC, TOP=OCR0A (DS table 11-8)
+            ;
+    TCCR0B  = (0<<CS02)  | (1<<CS01) | (1<<CS00)  // clk/64 (DS table 11-9)
+            | (0<<WGM02)
+            ;
+    OCR0A = 125 - 1;
+
     // set up e-switch
     SWITCH_PUE = (1 << SWITCH_PIN);  // pull-up for e-switch
     SWITCH_PCMSK = (1 << SWITCH_PCINT);  // enable pin change interrupt
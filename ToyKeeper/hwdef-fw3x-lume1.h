@@ -72,6 +72,12 @@ enum CHANNEL_MODES {
 #define PWM_TOP_INIT  1023
 #define PWM_CNT       TCNT1  // for dynamic PWM, reset phase
 
+// timer0 isn't used for PWM, so it's a 1 kHz clock for delays and
+// animations (see fsm-clock.h)
+#define MS_CLOCK_vect       TIMER0_COMPA_vect
+#define MS_CLOCK_INTCTRL    TIMSK
+#define MS_CLOCK_INT_bm     (1<<OCIE0A)
+
 // regulated channel
 #define CH1_PIN  PA6            // pin 1, Buck Boost CTRL pin or 7135-eqv PWM
 #define CH1_PWM  OCR1B          // OCR1B is the output compare register for PA6
@@ -192,6 +198,16 @@ inline void hwdef_setup() {
     // set PWM resolution
     PWM_TOP = PWM_TOP_INIT;
 
+    // configure ms clock
+    // F_clock = F_clkio / N / (OCR0A+1), where N = prescale factor
+    // (8 MHz / 64 / 125 = 1 kHz)
+    TCCR0A  = (1<<WGM01) | (0<<WGM00)  // CTC, TOP=OCR0A (DS table 11-8)
+            ;
+    TCCR0B  = (0<<CS02)  | (1<<CS01) | (1<<CS00)  // clk/64 (DS table 11-9)
+            | (0<<WGM02)
+            ;
+    OCR0A = 125 - 1;
+
     // set up e-switch
     SWITCH_PUE = (1 << SWITCH_PIN);  // pull-up for e-switch
     SWITCH_PCMSK = (1 << SWITCH_PCINT);  // enable pin change interrupt
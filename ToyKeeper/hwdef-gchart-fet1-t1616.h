@@ -37,6 +37,7 @@ enum CHANNEL_MODES {
 
 
 #define PWM_CHANNELS 2  // old, remove this
+#define USE_SET_LEVEL_2CH_STACKED  // used by hwdef-wurkkos-ts10.c channels[]
 
 #define PWM_BITS      16        // dynamic 16-bit, but never goes over 255
 #define PWM_GET       PWM_GET8
@@ -73,19 +73,26 @@ enum CHANNEL_MODES {
 #define PWM_TOP       ICR1   // holds the TOP value for variable-resolution PWM
 #define PWM_TOP_INIT  255
 #define PWM_CNT       TCNT1  // for checking / resetting phase
-// (max is (255 << 7), because it's 8-bit PWM plus 7 bits of DSM)
-#define DSM_TOP       (255<<7) // 15-bit resolution leaves 1 bit for carry
+
+// 8-bit PWM plus 7 bits of DSM (max is (255 << 7))
+#define USE_DELTA_SIGMA
+#define DSM_CHANNELS  1
+#define DSM_CH1_PWM   CH1_PWM
 
 // timer interrupt for DSM
 #define DSM_vect     TIMER1_OVF_vect
 #define DSM_INTCTRL  TIMSK
 #define DSM_OVF_bm   (1<<TOIE1)
 
+// timer0 isn't used for PWM, so it's a 1 kHz clock for delays and
+// animations (see fsm-clock.h)
+#define MS_CLOCK_vect       TIMER0_COMPA_vect
+#define MS_CLOCK_INTCTRL    TIMSK
+#define MS_CLOCK_INT_bm     (1<<OCIE0A)
+
 #define DELAY_FACTOR 90  // less time in delay() because more time spent in interrupts
 
 // regulated channel
-uint16_t ch1_dsm_lvl;
-uint8_t ch1_pwm, ch1_dsm;
 #define CH1_PIN          PB3    // pin 16, Opamp reference
 #define CH1_PWM          OCR1A  // OCR1A is the output compare register for PB3
 
@@ -196,6 +203,16 @@ inline void hwdef_setup() {
     // (moved to hwdef.c functions so it can be enabled/disabled based on ramp level)
     //DSM_INTCTRL |= DSM_OVF_bm;  // interrupt once for each timer cycle
 
+    // configure ms clock
+    // F_clock = F_clkio / N / (OCR0A+1), where N = prescale factor
+    // (8 MHz / 64 / 125 = 1 kHz)
+    TCCR0A  = (1<<WGM01) | (0<<WGM00)  // CTC, TOP=OCR0A (DS table 11-8)
+            ;
+    TCCR0B  = (0<<CS02)  | (1<<CS01) | (1<<CS00)  // clk/64 (DS table 11-9)
+            | (0<<WGM02)
+            ;
+    OCR0A = 125 - 1;
+
     // set up e-switch
     SWITCH_PUE = (1 << SWITCH_PIN);  // pull-up for e-switch
     SWITCH_PCMSK = (1 << SWITCH_PCINT);  // enable pin change interrupt
@@ -52,15 +52,9 @@ Channel channels[] = {
 
 
 void set_level_zero() {
-    // disable timer overflow interrupt
-    // (helps improve button press handling from Off state)
-    DSM_INTCTRL &= ~DSM_OVF_bm;
+    dsm_stop();
 
     // turn off all LEDs
-    ch1_dsm_lvl = 0;
-    ch2_dsm_lvl = 0;
-    CH1_PWM     = 0;
-    CH2_PWM     = 0;
     PWM_CNT     = 0;
     CH1_ENABLE_PORT &= ~(1 << CH1_ENABLE_PIN);  // disable opamp
     CH2_ENABLE_PORT &= ~(1 << CH2_ENABLE_PIN);  // disable opamp
@@ -68,7 +62,7 @@ void set_level_zero() {
 
 
 // wrap setting the dsm vars, to get a faster response
-// (just setting *_dsm_lvl doesn't work well for strobes)
+// (just setting dsm levels doesn't work well for strobes)
 // set new values for both channels,
 // handling any possible combination
 // and any before/after state
@@ -106,12 +100,11 @@ void set_hw_levels(PWM_DATATYPE ch1, PWM_DATATYPE ch2,
         CH2_ENABLE_PORT &= ~(1 << CH2_ENABLE_PIN);  // disable opamp
 
     // set delta-sigma soft levels
-    ch1_dsm_lvl = ch1;
-    ch2_dsm_lvl = ch2;
+    dsm_set(0, ch1);
+    dsm_set(1, ch2);
 
-    // set hardware PWM levels and init dsm loop
-    CH1_PWM = ch1_pwm = ch1 >> 7;
-    CH2_PWM = ch2_pwm = ch2 >> 7;
+    // set hardware PWM levels and start the dsm loop
+    dsm_start();
 
     #if 0  // not needed any more, after switching to PWM+DSM
     // manual phase sync when changing level while already on
@@ -120,41 +113,12 @@ void set_hw_levels(PWM_DATATYPE ch1, PWM_DATATYPE ch2,
     PWM_TOP = top;
     #endif
 
-    // enable timer overflow interrupt so DSM can work
-    DSM_INTCTRL |= DSM_OVF_bm;
-
     // reset phase when turning on
     //if ((! was_on) | (! now_on)) PWM_CNT = 0;
     if (! was_on) PWM_CNT = 0;
 
 }
 
-// delta-sigma modulation of PWM outputs
-// happens on each Timer overflow (every 512 cpu clock cycles)
-// uses 8-bit pwm w/ 7-bit dsm (0b 0PPP PPPP PDDD DDDD)
-ISR(DSM_vect) {
-    // set new hardware values first,
-    // for best timing (reduce effect of interrupt jitter)
-    CH1_PWM = ch1_pwm;
-    CH2_PWM = ch2_pwm;
-
-    // calculate next values, now that timing matters less
-
-    // accumulate error
-    ch1_dsm += (ch1_dsm_lvl & 0x007f);
-    // next PWM = base PWM value + carry bit
-    ch1_pwm  = (ch1_dsm_lvl >> 7) + (ch1_dsm > 0x7f);
-    // clear carry bit
-    ch1_dsm &= 0x7f;
-
-    // repeat for other channels
-
-    ch2_dsm += (ch2_dsm_lvl & 0x007f);
-    ch2_pwm  = (ch2_dsm_lvl >> 7) + (ch2_dsm > 0x7f);
-    ch2_dsm &= 0x7f;
-}
-
-
 void set_level_ch1(uint8_t level) {
     PWM_DATATYPE pwm = PWM_GET(pwm1_levels, level);
     set_hw_levels(pwm, 0,
@@ -210,26 +174,9 @@ void set_level_auto(uint8_t level) {
 
 ///// bump each channel toward a target value /////
 bool gradual_adjust(PWM_DATATYPE ch1, PWM_DATATYPE ch2) {
-    // adjust multiple times based on current brightness
-    // (so it adjusts faster/coarser when bright, slower/finer when dim)
-
-    // higher shift = slower/finer adjustments
-    const uint8_t shift = 9;  // ((255 << 7) >> 9) = 63 max
-    uint8_t steps;
-
-    steps = ch1_dsm_lvl >> shift;
-    for (uint8_t i=0; i<=steps; i++)
-        GRADUAL_ADJUST_SIMPLE(ch1, ch1_dsm_lvl);
-
-    steps = ch2_dsm_lvl  >> shift;
-    for (uint8_t i=0; i<=steps; i++)
-        GRADUAL_ADJUST_SIMPLE(ch2, ch2_dsm_lvl);
-
-    if ((ch1 == ch1_dsm_lvl)
-     && (ch2 == ch2_dsm_lvl )) {
-        return true;  // done
-    }
-    return false;  // not done yet
+    // (not "&&", because every channel needs a tick)
+    return dsm_gradual_tick(0, ch1)
+         & dsm_gradual_tick(1, ch2);
 }
 
 bool gradual_tick_ch1(uint8_t gt) {
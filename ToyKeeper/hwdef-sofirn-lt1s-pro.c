@@ -48,36 +48,6 @@ Channel channels[] = {
 };
 
 
-// calculate a 3-channel "auto tint" blend
-// (like red -> warm white -> cool white)
-// results are placed in *a, *b, and *c vars
-// level : ramp level to convert into 3 channel levels
-// (assumes ramp table is "pwm1_levels")
-void calc_auto_3ch_blend(
-    PWM_DATATYPE *a,
-    PWM_DATATYPE *b,
-    PWM_DATATYPE *c,
-    uint8_t level) {
-
-    PWM_DATATYPE vpwm = PWM_GET(pwm1_levels, level);
-
-    // tint goes from 0 (red) to 127 (warm white) to 255 (cool white)
-    uint8_t mytint;
-    mytint = 255 * (uint16_t)level / RAMP_SIZE;
-
-    // red is high at 0, low at 255 (linear)
-    *a = (((PWM_DATATYPE2)(255 - mytint)
-         * (PWM_DATATYPE2)vpwm) + 127) / 255;
-    // warm white is low at 0 and 255, high at 127 (linear triangle)
-    *b = (((PWM_DATATYPE2)triangle_wave(mytint)
-         * (PWM_DATATYPE2)vpwm) + 127) / 255;
-    // cool white is low at 0, high at 255 (linear)
-    *c = (((PWM_DATATYPE2)mytint
-         * (PWM_DATATYPE2)vpwm) + 127) / 255;
-
-}
-
-
 void set_level_zero() {
     WARM_PWM_LVL = 0;
     COOL_PWM_LVL = 0;
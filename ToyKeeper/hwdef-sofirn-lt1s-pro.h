@@ -40,7 +40,8 @@ enum channel_modes_e {
 
 // can use some of the common handlers
 #define USE_CALC_2CH_BLEND
-//#define USE_CALC_AUTO_3CH_BLEND
+#define USE_CALC_AUTO_3CH_BLEND
+#define AUTO_3CH_BLEND_LINEAR  // red and cool white fade over the whole ramp
 
 
 #define PWM_CHANNELS   1  // old, remove this
@@ -73,6 +73,10 @@
 
 /********* bring in FSM / SpaghettiMonster *********/
 #define USE_IDLE_MODE  // reduce power use while awake and no tasks are pending
+#define USE_EVENT_COALESCING  // don't let a slow loop() overflow the event queue
+#define USE_EVENT_DISPATCH_TABLE  // skip states which can't handle an event
+#define USE_ADAPTIVE_TICK  // tick slower while steady, to save power
+#define USE_ADAPTIVE_SLEEP_TICK  // sleep longer while off
 
 #include "spaghetti-monster.h"
 
@@ -87,6 +91,14 @@
 
 /********* Include all the regular app headers *********/
 
+#ifdef USE_TIMERS
+// which timer an EV_timer came from
+enum TIMER_IDS {
+    TIMER_SUNSET = 1,  // (0 means no event)
+    TIMER_OFF,
+};
+#endif
+
 #include "off-mode.h"
 #include "ramp-mode.h"
 #include "config-mode.h"
@@ -213,6 +225,26 @@
 #include "smooth-steps.c"
 #endif
 
+#ifdef USE_EVENT_DISPATCH_TABLE
+// which kinds of events each state can handle
+// (states not listed here get all events)
+const StateEvents state_events[] PROGMEM = {
+    #if defined(USE_CHANNEL_MODES)
+    // sits underneath every other state, and only handles button events
+    { channel_mode_state, EVK_BUTTON },
+    #endif
+    // the states where the light spends most of its time
+    // (none of them handle LVP, which falls through to default_state,
+    //  and only steady mode handles thermal events)
+    { off_state, EVK_BUTTON | EVK_TICK | EVK_SLEEP | EVK_OTHER },
+    { steady_state, EVK_BUTTON | EVK_TICK | EVK_THERMAL | EVK_OTHER },
+    #ifdef USE_LOCKOUT_MODE
+    { lockout_state, EVK_BUTTON | EVK_TICK | EVK_SLEEP | EVK_OTHER },
+    #endif
+    { NULL, EVK_ALL }
+};
+#endif
+
 
 // runs one time at boot, when power is connected
 void setup() {
@@ -344,16 +376,11 @@ void loop() {
     #endif
 
     #ifdef USE_SMOOTH_STEPS
-    else if (cfg.smooth_steps_style && smooth_steps_in_progress) {
-        smooth_steps_iter();
-    }
-    #endif
-
-    #ifdef USE_IDLE_MODE
-    else {
-        // doze until next clock tick
-        idle_mode();
-    }
+    // the modes above drive the emitter themselves, so a smooth step
+    // left over from the previous mode shouldn't keep changing the
+    // level underneath them  (it only plays in other modes)
+    else return;
+    if (smooth_steps_in_progress) smooth_steps_stop();
     #endif
 
 }
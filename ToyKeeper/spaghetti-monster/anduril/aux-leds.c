@@ -17,6 +17,9 @@ void indicator_led_update(uint8_t mode, uint8_t tick) {
     if (voltage < VOLTAGE_LOW) {
     #endif
         indicator_led(0);
+        #ifdef USE_ADAPTIVE_SLEEP_TICK
+        if (go_to_standby) allow_slow_ticks();
+        #endif
     }
     //#ifdef USE_INDICATOR_LOW_BAT_WARNING
     #ifndef DUAL_VOLTAGE_FLOOR // this isn't set up for dual-voltage lights like the Sofirn SP10 Pro
@@ -29,6 +32,9 @@ void indicator_led_update(uint8_t mode, uint8_t tick) {
     // normal steady output, 0/1/2 = off / low / high
     else if ((mode & 0b00001111) < 3) {
         indicator_led(mode);
+        #ifdef USE_ADAPTIVE_SLEEP_TICK
+        if (go_to_standby) allow_slow_ticks();
+        #endif
     }
     // beacon-like blinky mode
     else {
@@ -108,11 +114,18 @@ void rgb_led_update(uint8_t mode, uint16_t arg) {
         #ifdef USE_BUTTON_LED
         button_led_set(0);
         #endif
+        #ifdef USE_ADAPTIVE_SLEEP_TICK
+        if (go_to_standby) allow_slow_ticks();
+        #endif
         return;
     }
 
     uint8_t pattern = (mode>>4);  // off, low, high, blinking, ... more?
     uint8_t color = mode & 0x0f;
+    #ifdef USE_ADAPTIVE_SLEEP_TICK
+    // nothing to animate?  then standby can skip some frames
+    uint8_t steady = (pattern < 3) && ((color < 7) || (color > 8));
+    #endif
 
     // always preview in high mode
     if (setting_rgb_mode_now) { pattern = 2; }
@@ -128,6 +141,9 @@ void rgb_led_update(uint8_t mode, uint16_t arg) {
         pattern = 1 + ((2 == pattern) | (prev_level >= POST_OFF_VOLTAGE_BRIGHTNESS));
         // voltage mode
         color = RGB_LED_NUM_COLORS - 1;
+        #ifdef USE_ADAPTIVE_SLEEP_TICK
+        steady = 0;  // (wake up on time to end it)
+        #endif
     }
     #endif
 
@@ -199,6 +215,9 @@ void rgb_led_update(uint8_t mode, uint16_t arg) {
     #ifdef USE_BUTTON_LED
     button_led_set(button_led_result);
     #endif
+    #ifdef USE_ADAPTIVE_SLEEP_TICK
+    if (go_to_standby && steady) allow_slow_ticks();
+    #endif
 }
 
 void rgb_led_voltage_readout(uint8_t bright) {
@@ -1,20 +1,68 @@
 #!/bin/sh
 
-# Usage: build-all.sh [pattern]
+# Usage: build-all.sh [-j N] [pattern]
 # If pattern given, only build targets which match.
+# With -j N, build up to N targets at once.
+# Targets are only recompiled when their preprocessed source changed.
+# (set FORCE=1 to rebuild everything anyway)
+# Afterward, a table of flash / RAM / EEPROM usage goes into sizes.txt,
+# compared against sizes.baseline if it exists.
+# (set SAVE_SIZES=1 to make this build the new baseline)
+
+UI=anduril
+
+# build one target (used internally, so targets can run in parallel)
+if [ "$1" = "--target" ]; then
+  TARGET="$2"
+
+  # friendly name for this build
+  NAME=$(echo "$TARGET" | perl -ne '/cfg-(.*).h/ && print "$1\n";')
+
+  # figure out MCU type
+  ATTINY=$(grep 'ATTINY:' $TARGET | awk '{ print $3 }')
+  if [ -z "$ATTINY" ]; then ATTINY=85 ; fi
+
+  # each target gets its own intermediate files
+  # (and the .hash file lets unchanged targets skip the compile)
+  if [ -n "$FORCE" ]; then rm -f "$UI".$NAME.hash ; fi
+
+  # try to compile
+  # (collect output and print it all at once, so parallel builds
+  #  don't scramble each other's logs)
+  LOG=$(
+    echo "===== $NAME ====="
+    echo ../../../bin/build.sh $ATTINY "$UI" "-DCFG_H=${TARGET}"
+    OUT="$UI".$NAME INCREMENTAL=1 \
+      ../../../bin/build.sh $ATTINY "$UI" "-DCFG_H=${TARGET}" 2>&1
+    echo "RESULT $?"
+  )
+  RESULT=$(echo "$LOG" | tail -n 1 | awk '{ print $2 }')
+  echo "$LOG" | sed '$d'
+
+  # track result
+  if [ 0 = "$RESULT" ] ; then
+    echo "PASS $NAME $ATTINY" >> "$RESULTS"
+  else
+    echo "ERROR: build failed"
+    echo "FAIL $NAME" >> "$RESULTS"
+  fi
+  exit 0
+fi
+
+JOBS=1
+if [ "$1" = "-j" ]; then
+  JOBS="$2"
+  shift ; shift
+fi
 
 if [ ! -z "$1" ]; then
   SEARCH="$1"
 fi
 
-UI=anduril
-
 date '+#define VERSION_NUMBER "%Y-%m-%d"' > version.h
 
-PASS=0
-FAIL=0
-PASSED=''
-FAILED=''
+RESULTS=$(mktemp)
+export RESULTS FORCE
 
 for TARGET in cfg-*.h ; do
 
@@ -24,34 +72,29 @@ for TARGET in cfg-*.h ; do
     if [ 0 != $? ]; then continue ; fi
   fi
 
-  # friendly name for this build
-  NAME=$(echo "$TARGET" | perl -ne '/cfg-(.*).h/ && print "$1\n";')
-  echo "===== $NAME ====="
+  echo "$TARGET"
 
-  # figure out MCU type
-  ATTINY=$(grep 'ATTINY:' $TARGET | awk '{ print $3 }')
-  if [ -z "$ATTINY" ]; then ATTINY=85 ; fi
-
-  # try to compile
-  echo ../../../bin/build.sh $ATTINY "$UI" "-DCFG_H=${TARGET}"
-  ../../../bin/build.sh $ATTINY "$UI" "-DCFG_H=${TARGET}"
-
-  # track result, and rename compiled files
-  if [ 0 = $? ] ; then
-    mv -f "$UI".hex "$UI".$NAME.hex
-    PASS=$(($PASS + 1))
-    PASSED="$PASSED $NAME"
-  else
-    echo "ERROR: build failed"
-    FAIL=$(($FAIL + 1))
-    FAILED="$FAILED $NAME"
-  fi
+done | xargs -P "$JOBS" -n 1 "$0" --target
 
-done
+PASS=$(grep -c '^PASS' "$RESULTS")
+FAIL=$(grep -c '^FAIL' "$RESULTS")
+PASSED=$(grep '^PASS' "$RESULTS" | awk '{ print $2 }' | sort | tr '\n' ' ')
+FAILED=$(grep '^FAIL' "$RESULTS" | awk '{ print $2 }' | sort | tr '\n' ' ')
+SIZEARGS=$(grep '^PASS' "$RESULTS" | awk '{ print $3 ":'"$UI"'." $2 ".elf" }' | sort)
+rm -f "$RESULTS"
 
 # summary
 echo "===== $PASS builds succeeded, $FAIL failed ====="
 #echo "PASS: $PASSED"
 if [ 0 != $FAIL ]; then
-  echo "FAIL:$FAILED"
+  echo "FAIL: $FAILED"
+fi
+
+# size report
+if [ -n "$SIZEARGS" ]; then
+  SIZEFLAGS="--baseline sizes.baseline"
+  if [ -n "$SAVE_SIZES" ]; then SIZEFLAGS="$SIZEFLAGS --save sizes.baseline" ; fi
+  ../../../bin/size-report.py $SIZEFLAGS $SIZEARGS > sizes.txt
+  grep -v '^##' sizes.txt
+  echo "(full report in sizes.txt)"
 fi
@@ -45,11 +45,12 @@ uint8_t candle_mode_state(Event event, uint16_t arg) {
         return EVENT_HANDLED;
     }
     #ifdef USE_SUNSET_TIMER
-    // 2 clicks: cancel timer
-    else if (event == EV_2clicks) {
+    // 2 or 4 clicks: cancel timer
+    else if ((event == EV_2clicks) || (event == EV_4clicks)) {
         // parent state just rotated through strobe/flasher modes,
         // so cancel timer...  in case any time was left over from earlier
         sunset_timer = 0;
+        timer_stop(&sunset_minute);
         return EVENT_HANDLED;
     }
     #endif  // ifdef USE_SUNSET_TIMER
@@ -81,7 +82,7 @@ uint8_t candle_mode_state(Event event, uint16_t arg) {
     // clock tick: animate candle brightness
     else if (event == EV_tick) {
         // un-reverse after 1 second
-        if (arg == AUTO_REVERSE_TIME) ramp_direction = 1;
+        if (arg >= AUTO_REVERSE_TIME) ramp_direction = 1;
 
         // 3-oscillator synth for a relatively organic pattern
         uint8_t add;
@@ -94,7 +95,7 @@ uint8_t candle_mode_state(Event event, uint16_t arg) {
         #ifdef USE_SUNSET_TIMER
         if (1 == sunset_timer) {
             brightness = brightness
-                         * ((TICKS_PER_MINUTE>>5) - (sunset_ticks>>5))
+                         * ((TICKS_PER_MINUTE>>5) - (sunset_ticks()>>5))
                          / (TICKS_PER_MINUTE>>5);
         }
         #endif  // ifdef USE_SUNSET_TIMER
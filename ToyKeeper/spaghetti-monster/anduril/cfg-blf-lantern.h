@@ -29,8 +29,8 @@
 #define RAMP_SIZE 150
 // delta-sigma modulated PWM (0b0HHHHHHHHLLLLLLL = 0, 8xHigh, 7xLow bits)
 // (max is (255 << 7), because it's 8-bit PWM plus 7 bits of DSM)
-// level_calc.py 3.333 1 150 7135 32 0.2 600 --pwm 32640
-#define PWM1_LEVELS  32,35,38,41,45,50,55,61,67,74,82,91,100,110,121,133,146,160,175,192,209,227,247,268,291,314,340,366,395,424,456,489,524,560,599,639,681,726,772,820,871,924,979,1036,1096,1158,1222,1289,1359,1431,1506,1584,1664,1747,1834,1923,2015,2111,2209,2311,2416,2524,2636,2751,2870,2992,3118,3247,3380,3518,3659,3803,3952,4105,4262,4423,4589,4759,4933,5111,5294,5482,5674,5871,6073,6279,6491,6707,6928,7155,7386,7623,7865,8113,8365,8624,8888,9157,9432,9713,10000,10292,10591,10895,11206,11523,11846,12175,12511,12853,13202,13557,13919,14287,14663,15045,15434,15830,16233,16644,17061,17486,17919,18358,18805,19260,19723,20193,20671,21156,21650,22152,22662,23180,23706,24241,24784,25335,25895,26464,27041,27627,28222,28826,29439,30060,30691,31332,31981,32640
+// (tables are generated at build time by bin/ramp-gen.py)
+#define RAMP_SPEC "3.333 1 150 7135 32 0.2 600 --pwm 32640"
 
 #define DEFAULT_LEVEL 75
 #define MAX_1x7135 75
@@ -14,6 +14,8 @@
 // the ramp uses only 1x7135 chip, max ~130 lm
 #undef PWM_CHANNELS
 #define PWM_CHANNELS 1
+#undef USE_SET_LEVEL_2CH_STACKED
+#define USE_SET_LEVEL_1CH
 
 #undef PWM1_LEVELS
 #undef PWM2_LEVELS
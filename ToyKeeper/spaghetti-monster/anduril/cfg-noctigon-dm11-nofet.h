@@ -13,6 +13,8 @@
 // turn off the DD FET
 #undef PWM_CHANNELS
 #define PWM_CHANNELS 1
+#undef USE_SET_LEVEL_2CH_STACKED
+#define USE_SET_LEVEL_1CH
 #define RAMP_SIZE 150
 
 // level_calc.py 5.01 1 149 7135 1 0.3 1740 --pwm dyn:78:16384:255
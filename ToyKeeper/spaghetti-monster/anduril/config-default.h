@@ -189,6 +189,12 @@
 #define USE_LOWPASS_WHILE_ASLEEP
 #endif
 
+// store ramp tables in a smaller format, where space is tight
+// (bin/build.sh packs them, and lights without 8-bit tables ignore this)
+#if (ATTINY==85)
+#define USE_PACKED_RAMPS
+#endif
+
 // if there's tint ramping, allow user to set it smooth or stepped
 #define USE_STEPPED_TINT_RAMPING
 #define DEFAULT_TINT_RAMP_STYLE 0  // smooth
@@ -24,6 +24,7 @@ uint8_t boring_strobe_state(Event event, uint16_t arg) {
     // 2 clicks: rotate through strobe/flasher modes
     else if (event == EV_2clicks) {
         boring_strobe_type = (st + 1) % NUM_BORING_STROBES;
+        anim_stop();  // start the new one right away
         return EVENT_HANDLED;
     }
     return EVENT_NOT_HANDLED;
@@ -33,7 +34,11 @@ inline void boring_strobe_state_iter() {
     switch(boring_strobe_type) {
         #ifdef USE_POLICE_STROBE_MODE
         case 0: // police strobe
-            police_strobe_iter();
+            // (keeps going on its own, once it has started)
+            if (! anim_busy()) {
+                police_strobe_step = 0;
+                anim_start(police_strobe_frame, 0);
+            }
             break;
         #endif
 
@@ -46,17 +51,19 @@ inline void boring_strobe_state_iter() {
 }
 
 #ifdef USE_POLICE_STROBE_MODE
-inline void police_strobe_iter() {
-    // one iteration of main loop()
+uint16_t police_strobe_frame() {
     // flash at 16 Hz then 8 Hz, 8 times each
-    for (uint8_t del=41; del<100; del+=41) {
-        for (uint8_t f=0; f<8; f++) {
-            set_level(STROBE_BRIGHTNESS);
-            nice_delay_ms(del >> 1);
-            set_level(0);
-            nice_delay_ms(del);
-        }
+    // (even steps flash, odd steps are the gaps between)
+    uint8_t step = police_strobe_step;
+    police_strobe_step = (step + 1) & 31;
+    uint8_t del = (step < 16) ? 41 : 82;
+
+    if (step & 1) {
+        set_level(0);
+        return del;
     }
+    set_level(STROBE_BRIGHTNESS);
+    return del >> 1;
 }
 #endif
 
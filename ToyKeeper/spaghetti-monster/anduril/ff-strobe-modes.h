@@ -9,7 +9,8 @@ inline void boring_strobe_state_iter();
 uint8_t boring_strobe_type = 0;
 void sos_blink(uint8_t num, uint8_t dah);
 #ifdef USE_POLICE_STROBE_MODE
-inline void police_strobe_iter();
+uint8_t police_strobe_step;  // flash / gap number in this cycle
+uint16_t police_strobe_frame();
 #endif
 #define NUM_BORING_STROBES 2
 
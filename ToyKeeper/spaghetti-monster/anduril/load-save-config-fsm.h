@@ -5,6 +5,8 @@
 #pragma once
 
 #define USE_EEPROM
+// save in the background, so saving doesn't pause everything else
+#define USE_EEPROM_ASYNC
 // load into a custom RAM location instead of FSM's default byte array
 #define EEPROM_OVERRIDE
 
@@ -17,26 +19,64 @@
 // let FSM know this config struct exists
 #define USE_CFG
 
+// which version of the Config layout this firmware saves
+// (layouts before this byte existed used one byte per option, and started
+//  with ramp_style, so the first byte there was always 0 or 1)
+#define CONFIG_LAYOUT 2
+
+// convert settings saved in an older layout, instead of resetting them
+#ifndef DONT_USE_CONFIG_MIGRATION
+#define USE_CONFIG_MIGRATION
+#endif
+
+// options with only a few possible values are packed into bitfields,
+// so they're grouped together at the start
+#if NUM_CHANNEL_MODES > 16
+#error Channel modes need more than 4 bits in Config.
+#endif
+
 typedef struct Config {
 
-    ///// ramp vars
-    uint8_t ramp_style;
+    uint8_t layout_version;
+
+    ///// small options, packed
+    uint8_t ramp_style : 1;  // 0 = smooth, 1 = discrete
     #ifdef USE_2C_STYLE_CONFIG
-        uint8_t ramp_2c_style;
-    #endif
-    #ifdef USE_RAMP_CONFIG
-        uint8_t ramp_floors[NUM_RAMPS];
-        uint8_t ramp_ceils [NUM_RAMPS];
-        uint8_t ramp_stepss[NUM_RAMPS];
+        uint8_t ramp_2c_style : 2;
     #endif
     #ifdef USE_SIMPLE_UI
-        uint8_t simple_ui_active;
+        uint8_t simple_ui_active : 1;
         #ifdef USE_2C_STYLE_CONFIG
-            uint8_t ramp_2c_style_simple;
+            uint8_t ramp_2c_style_simple : 2;
         #endif
     #endif
     #ifdef USE_RAMP_AFTER_MOON_CONFIG
-        uint8_t dont_ramp_after_moon;
+        uint8_t dont_ramp_after_moon : 1;
+    #endif
+    #ifdef USE_SMOOTH_STEPS
+        uint8_t smooth_steps_style : 1;
+    #endif
+    #if NUM_CHANNEL_MODES > 1
+        uint8_t channel_mode : 4;
+        #ifdef USE_MANUAL_MEMORY
+            uint8_t manual_memory_channel_mode : 4;
+        #endif
+        #ifdef DEFAULT_BLINK_CHANNEL
+            uint8_t blink_channel : 4;
+        #endif
+    #endif
+    #ifdef USE_STROBE_STATE
+        uint8_t strobe_type : 4;
+    #endif
+    #ifdef USE_INDICATOR_LED
+        uint8_t indicator_led_mode : 4;
+    #endif
+
+    ///// ramp vars
+    #ifdef USE_RAMP_CONFIG
+        uint8_t ramp_floors[NUM_RAMPS];
+        uint8_t ramp_ceils [NUM_RAMPS];
+        uint8_t ramp_stepss[NUM_RAMPS];
     #endif
     #ifdef USE_MANUAL_MEMORY
         uint8_t manual_memory;
@@ -47,14 +87,7 @@ typedef struct Config {
 
     ///// channel modes / color modes
     #if NUM_CHANNEL_MODES > 1
-        uint8_t channel_mode;
         uint16_t channel_modes_enabled;
-        #ifdef USE_MANUAL_MEMORY
-            uint8_t manual_memory_channel_mode;
-        #endif
-        #ifdef DEFAULT_BLINK_CHANNEL
-            uint8_t blink_channel;
-        #endif
     #endif
     #ifdef USE_CHANNEL_MODE_ARGS
         // this is an array, needs a few bytes
@@ -67,17 +100,9 @@ typedef struct Config {
         #endif
     #endif
 
-    ///// Smooth animation between steps, and for on/off
-    #ifdef USE_SMOOTH_STEPS
-        uint8_t smooth_steps_style;
-    #endif
-
     ///// strobe / blinky mode settings
-    #ifdef USE_STROBE_STATE
-        uint8_t strobe_type;
-        #if (NUM_CHANNEL_MODES > 1) && defined(USE_CHANNEL_PER_STROBE)
-            uint8_t strobe_channels[NUM_STROBES];
-        #endif
+    #if defined(USE_STROBE_STATE) && (NUM_CHANNEL_MODES > 1) && defined(USE_CHANNEL_PER_STROBE)
+        uint8_t strobe_channels[NUM_STROBES];
     #endif
     #if defined(USE_PARTY_STROBE_MODE) || defined(USE_TACTICAL_STROBE_MODE)
         uint8_t strobe_delays[2];
@@ -99,9 +124,6 @@ typedef struct Config {
     #endif
 
     ///// aux LEDs
-    #ifdef USE_INDICATOR_LED
-        uint8_t indicator_led_mode;
-    #endif
     #ifdef USE_AUX_RGB_LEDS
         uint8_t rgb_led_off_mode;
         uint8_t rgb_led_lockout_mode;
@@ -7,13 +7,175 @@
 #include "load-save-config-fsm.h"
 #include "load-save-config.h"
 
+#ifdef USE_CONFIG_MIGRATION
+uint8_t *old_cfg;  // next byte of settings in the old layout
+
+uint8_t old_cfg_byte() {
+    return eeprom_read_byte(old_cfg++);
+}
+
+void old_cfg_bytes(uint8_t *dest, uint8_t len) {
+    while (len--) *dest++ = old_cfg_byte();
+}
+
+// for options which are now bitfields:
+// use the default if the old value doesn't fit
+uint8_t old_cfg_byte_below(uint8_t limit, uint8_t dflt) {
+    uint8_t val = old_cfg_byte();
+    return (val < limit) ? val : dflt;
+}
+
+// load settings saved in the old layout, with one byte per option,
+// in the order they were declared before options were packed
+void load_config_v1(uint8_t *saved) {
+    old_cfg = saved;
+
+    ///// ramp vars
+    cfg.ramp_style = old_cfg_byte();
+    #ifdef USE_2C_STYLE_CONFIG
+        uint8_t style = old_cfg_byte();
+        cfg.ramp_2c_style = (style > 2) ? 2 : style;
+    #endif
+    #ifdef USE_RAMP_CONFIG
+        old_cfg_bytes(cfg.ramp_floors, NUM_RAMPS);
+        old_cfg_bytes(cfg.ramp_ceils,  NUM_RAMPS);
+        old_cfg_bytes(cfg.ramp_stepss, NUM_RAMPS);
+    #endif
+    #ifdef USE_SIMPLE_UI
+        cfg.simple_ui_active = (old_cfg_byte() > 0);
+        #ifdef USE_2C_STYLE_CONFIG
+            style = old_cfg_byte();
+            cfg.ramp_2c_style_simple = (style > 2) ? 2 : style;
+        #endif
+    #endif
+    #ifdef USE_RAMP_AFTER_MOON_CONFIG
+        cfg.dont_ramp_after_moon = (old_cfg_byte() > 0);
+    #endif
+    #ifdef USE_MANUAL_MEMORY
+        cfg.manual_memory = old_cfg_byte();
+        #ifdef USE_MANUAL_MEMORY_TIMER
+            cfg.manual_memory_timer = old_cfg_byte();
+        #endif
+    #endif
+
+    ///// channel modes / color modes
+    #if NUM_CHANNEL_MODES > 1
+        cfg.channel_mode = old_cfg_byte_below(
+                NUM_CHANNEL_MODES, DEFAULT_CHANNEL_MODE);
+        old_cfg_bytes((uint8_t *)&cfg.channel_modes_enabled, 2);
+        #ifdef USE_MANUAL_MEMORY
+            cfg.manual_memory_channel_mode = old_cfg_byte_below(
+                    NUM_CHANNEL_MODES, DEFAULT_CHANNEL_MODE);
+        #endif
+        #ifdef DEFAULT_BLINK_CHANNEL
+            cfg.blink_channel = old_cfg_byte_below(
+                    NUM_CHANNEL_MODES, DEFAULT_BLINK_CHANNEL);
+        #endif
+    #endif
+    #ifdef USE_CHANNEL_MODE_ARGS
+        old_cfg_bytes(cfg.channel_mode_args, NUM_CHANNEL_MODES);
+        #ifdef USE_MANUAL_MEMORY
+            old_cfg_bytes(cfg.manual_memory_channel_args, NUM_CHANNEL_MODES);
+        #endif
+        #ifdef USE_STEPPED_TINT_RAMPING
+            cfg.tint_ramp_style = old_cfg_byte();
+        #endif
+    #endif
+
+    ///// Smooth animation between steps, and for on/off
+    #ifdef USE_SMOOTH_STEPS
+        cfg.smooth_steps_style = (old_cfg_byte() > 0);
+    #endif
+
+    ///// strobe / blinky mode settings
+    #ifdef USE_STROBE_STATE
+        cfg.strobe_type = old_cfg_byte_below(NUM_STROBES, DEFAULT_STROBE);
+        #if (NUM_CHANNEL_MODES > 1) && defined(USE_CHANNEL_PER_STROBE)
+            old_cfg_bytes(cfg.strobe_channels, NUM_STROBES);
+        #endif
+    #endif
+    #if defined(USE_PARTY_STROBE_MODE) || defined(USE_TACTICAL_STROBE_MODE)
+        old_cfg_bytes(cfg.strobe_delays, 2);
+    #endif
+    #ifdef USE_BIKE_FLASHER_MODE
+        cfg.bike_flasher_brightness = old_cfg_byte();
+    #endif
+    #ifdef USE_BEACON_MODE
+        cfg.beacon_seconds = old_cfg_byte();
+    #endif
+
+    ///// voltage and temperature
+    #ifdef USE_VOLTAGE_CORRECTION
+        cfg.voltage_correction = old_cfg_byte();
+    #endif
+    #ifdef USE_THERMAL_REGULATION
+        cfg.therm_ceil = old_cfg_byte();
+        cfg.therm_cal_offset = old_cfg_byte();
+    #endif
+
+    ///// aux LEDs
+    #ifdef USE_INDICATOR_LED
+        // off mode in the low 2 bits, lockout mode in the next 2
+        uint8_t mode = old_cfg_byte();
+        #ifdef TICK_DURING_STANDBY
+        #define OLD_INDICATOR_MODES 4
+        #else
+        #define OLD_INDICATOR_MODES 3
+        #endif
+        if ((mode > 0x0f)
+            || ((mode & 0x03) >= OLD_INDICATOR_MODES)
+            || ((mode >> 2) >= OLD_INDICATOR_MODES))
+            mode = INDICATOR_LED_DEFAULT_MODE;
+        cfg.indicator_led_mode = mode;
+    #endif
+    #ifdef USE_AUX_RGB_LEDS
+        cfg.rgb_led_off_mode = old_cfg_byte();
+        cfg.rgb_led_lockout_mode = old_cfg_byte();
+        #ifdef USE_POST_OFF_VOLTAGE
+            cfg.post_off_voltage = old_cfg_byte();
+        #endif
+    #endif
+
+    ///// misc other mode settings
+    #ifdef USE_AUTOLOCK
+        cfg.autolock_time = old_cfg_byte();
+    #endif
+    #ifdef USE_TACTICAL_MODE
+        old_cfg_bytes(cfg.tactical_levels, 3);
+    #endif
+
+    ///// hardware config / globals menu
+    #ifdef USE_JUMP_START
+        cfg.jump_start_level = old_cfg_byte();
+    #endif
+}
+#endif  // ifdef USE_CONFIG_MIGRATION
+
 void load_config() {
     eeprom = (uint8_t *)&cfg;
 
-    if (! load_eeprom()) return;
+    #ifdef START_AT_MEMORIZED_LEVEL
+    // (always load this, because it also finds where the next save goes)
+    uint8_t found_wl = load_eeprom_wl();
+    #endif
+
+    // saved settings only fit into cfg if they use the same layout
+    uint8_t *saved = find_eeprom();
+    if (! saved) return;
+    uint8_t layout = eeprom_read_byte(saved);
+    #ifdef USE_CONFIG_MIGRATION
+    if (layout <= 1) {
+        // convert old settings...  but don't write them back until the
+        // user changes something, so booting doesn't cost an erase cycle
+        // (and going back to an older version still works until then)
+        load_config_v1(saved);
+    }
+    else
+    #endif
+    if ((layout != CONFIG_LAYOUT) || (! load_eeprom())) return;
 
     #ifdef START_AT_MEMORIZED_LEVEL
-    if (load_eeprom_wl()) {
+    if (found_wl) {
         memorized_level = eeprom_wl[0];
     }
     #endif
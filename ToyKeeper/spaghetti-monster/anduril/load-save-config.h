@@ -14,6 +14,8 @@ void save_config_wl();
 // a struct to hold config values
 Config cfg = {
 
+    .layout_version = CONFIG_LAYOUT,
+
     ///// ramp vars
 
     // smooth vs discrete ramping
@@ -7,5 +7,6 @@
 // autolock function requires the ability to measure time while "off"
 #ifdef USE_AUTOLOCK
 #define TICK_DURING_STANDBY
+#define USE_TIMERS
 #endif
 
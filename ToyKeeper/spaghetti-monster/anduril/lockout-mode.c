@@ -34,6 +34,18 @@ uint8_t lockout_state(Event event, uint16_t arg) {
     }
     #endif  // ifdef USE_MOON_DURING_LOCKOUT_MODE
 
+    #ifdef USE_OFF_TIMER
+    // button presses count as activity, for the manual memory timer
+    // (restart it when the button goes down or up, not every hold frame)
+    {
+        uint8_t flags = event & B_FLAGS;
+        if ((flags == (B_CLICK | B_PRESS))  // press
+            || (flags == (B_CLICK | B_RELEASE))  // release after a click
+            || (flags == (B_CLICK | B_HOLD | B_RELEASE | B_TIMEOUT)))  // ... or a hold
+            off_timer_start();
+    }
+    #endif
+
     // regular event handling
     // conserve power while locked out
     // (allow staying awake long enough to exit, but otherwise
@@ -41,6 +53,9 @@ uint8_t lockout_state(Event event, uint16_t arg) {
     //  even if the user keeps pressing the button)
     if (event == EV_enter_state) {
         ticks_since_on = 0;
+        #ifdef USE_OFF_TIMER
+        off_timer_start();
+        #endif
         #ifdef USE_INDICATOR_LED
             // redundant, sleep tick does the same thing
             // indicator_led_update(cfg.indicator_led_mode >> 2, 0);
@@ -62,20 +77,39 @@ uint8_t lockout_state(Event event, uint16_t arg) {
         return EVENT_HANDLED;
     }
 
-    #if defined(TICK_DURING_STANDBY) && (defined(USE_INDICATOR_LED) || defined(USE_AUX_RGB_LEDS))
-    else if (event == EV_sleep_tick) {
-        if (ticks_since_on < 255) ticks_since_on ++;
+    #ifdef USE_OFF_TIMER
+    else if (event == EV_leave_state) {
+        timer_stop(&off_timer);
+        return EVENT_HANDLED;
+    }
+    else if (event == EV_reenter_state) {
+        off_timer_start();
+        return EVENT_HANDLED;
+    }
+
+    // right away, then once per minute while locked
+    else if ((event == EV_timer) && (arg == TIMER_OFF)) {
         #ifdef USE_MANUAL_MEMORY_TIMER
         // reset to manual memory level when timer expires
         if (cfg.manual_memory &&
-                (arg >= (cfg.manual_memory_timer * SLEEP_TICKS_PER_MINUTE))) {
+                (off_minutes >= cfg.manual_memory_timer)) {
             manual_memory_restore();
         }
         #endif
+        if (off_minutes < 255) off_minutes ++;
+        return EVENT_HANDLED;
+    }
+    #endif
+
+    #if defined(TICK_DURING_STANDBY) && (defined(USE_INDICATOR_LED) || defined(USE_AUX_RGB_LEDS) || defined(USE_ADAPTIVE_SLEEP_TICK))
+    else if (event == EV_sleep_tick) {
+        if (ticks_since_on < 255) ticks_since_on ++;
         #if defined(USE_INDICATOR_LED)
         indicator_led_update(cfg.indicator_led_mode >> 2, arg);
         #elif defined(USE_AUX_RGB_LEDS)
         rgb_led_update(cfg.rgb_led_lockout_mode, arg);
+        #else
+        allow_slow_ticks();  // nothing to animate
         #endif
         return EVENT_HANDLED;
     }
@@ -27,6 +27,9 @@ uint8_t momentary_state(Event event, uint16_t arg) {
     // button was released
     else if ((event & (B_CLICK | B_PRESS)) == (B_CLICK)) {
         momentary_active = 0;
+        #ifdef USE_STROBE_STATE
+        anim_stop();  // stop momentary strobes
+        #endif
         set_level(0);
         //go_to_standby = 1;  // sleep while light is off
         return EVENT_HANDLED;
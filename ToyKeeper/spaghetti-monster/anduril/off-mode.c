@@ -39,6 +39,9 @@ uint8_t off_state(Event event, uint16_t arg) {
         #ifdef USE_SUNSET_TIMER
         sunset_timer = 0;  // needs a reset in case previous timer was aborted
         #endif
+        #ifdef USE_OFF_TIMER
+        off_timer_start();
+        #endif
         // sleep while off  (lower power use)
         // (unless delay requested; give the ADC some time to catch up)
         if (! arg) { go_to_standby = 1; }
@@ -64,30 +67,49 @@ uint8_t off_state(Event event, uint16_t arg) {
         return EVENT_HANDLED;
     }
 
-    #if defined(TICK_DURING_STANDBY)
-    // blink the indicator LED, maybe
-    else if (event == EV_sleep_tick) {
-        if (ticks_since_on < 255) ticks_since_on ++;
+    #ifdef USE_OFF_TIMER
+    // count how long it's been off, but not while it's on or in a menu
+    else if (event == EV_leave_state) {
+        timer_stop(&off_timer);
+        return EVENT_HANDLED;
+    }
+    else if (event == EV_reenter_state) {
+        off_timer_start();
+        return EVENT_HANDLED;
+    }
+
+    // right away, then once per minute while off
+    else if ((event == EV_timer) && (arg == TIMER_OFF)) {
         #ifdef USE_MANUAL_MEMORY_TIMER
         // reset to manual memory level when timer expires
         if (cfg.manual_memory &&
-                (arg >= (cfg.manual_memory_timer * SLEEP_TICKS_PER_MINUTE))) {
+                (off_minutes >= cfg.manual_memory_timer)) {
             manual_memory_restore();
         }
         #endif
-        #ifdef USE_INDICATOR_LED
-        indicator_led_update(cfg.indicator_led_mode & 0x03, arg);
-        #elif defined(USE_AUX_RGB_LEDS)
-        rgb_led_update(cfg.rgb_led_off_mode, arg);
-        #endif
-
         #ifdef USE_AUTOLOCK
             // lock the light after being off for N minutes
-            uint16_t ticks = cfg.autolock_time * SLEEP_TICKS_PER_MINUTE;
-            if ((cfg.autolock_time > 0)  && (arg > ticks)) {
+            if ((cfg.autolock_time > 0)  && (off_minutes >= cfg.autolock_time)) {
                 set_state(lockout_state, 0);
+                return EVENT_HANDLED;
             }
         #endif  // ifdef USE_AUTOLOCK
+        if (off_minutes < 255) off_minutes ++;
+        return EVENT_HANDLED;
+    }
+    #endif
+
+    #if defined(TICK_DURING_STANDBY)
+    // blink the indicator LED, maybe
+    else if (event == EV_sleep_tick) {
+        if (ticks_since_on < 255) ticks_since_on ++;
+        #ifdef USE_INDICATOR_LED
+        indicator_led_update(cfg.indicator_led_mode & 0x03, arg);
+        #elif defined(USE_AUX_RGB_LEDS)
+        rgb_led_update(cfg.rgb_led_off_mode, arg);
+        #elif defined(USE_ADAPTIVE_SLEEP_TICK)
+        allow_slow_ticks();  // nothing to animate
+        #endif
         return EVENT_HANDLED;
     }
     #endif
@@ -202,7 +224,7 @@ uint8_t off_state(Event event, uint16_t arg) {
     else if (event == EV_click3_press) {
         #ifdef USE_SMOOTH_STEPS
             // immediately cancel any animations in progress
-            smooth_steps_in_progress = 0;
+            anim_stop();
         #endif
         off_state_set_level(0);
         return EVENT_HANDLED;
@@ -382,3 +404,9 @@ void off_state_set_level(uint8_t level) {
     set_level(level);
 }
 
+#ifdef USE_OFF_TIMER
+void off_timer_start() {
+    off_minutes = 0;
+    timer_start(&off_timer, 0, TICKS_PER_MINUTE);
+}
+#endif
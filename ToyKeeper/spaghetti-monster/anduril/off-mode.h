@@ -10,3 +10,11 @@ uint8_t ticks_since_on = 0;
 // when the light is "off" or in standby
 uint8_t off_state(Event event, uint16_t arg);
 
+#if defined(USE_AUTOLOCK) || defined(USE_MANUAL_MEMORY_TIMER)
+// how long the light has been off (or locked), for timeouts
+#define USE_OFF_TIMER
+Timer off_timer = { .id = TIMER_OFF };  // due right away, then each minute
+uint8_t off_minutes = 0;
+void off_timer_start();
+#endif
+
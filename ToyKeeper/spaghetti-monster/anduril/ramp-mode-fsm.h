@@ -20,9 +20,20 @@
 #define DEFAULT_LEVEL MAX_1x7135
 #endif
 
+// smooth steps are animated in the background
+#ifdef USE_SMOOTH_STEPS
+#define USE_ANIMATION
+#endif
+
 // requires the ability to measure time while "off"
 #ifdef USE_MANUAL_MEMORY_TIMER
 #define TICK_DURING_STANDBY
+#define USE_TIMERS
+#endif
+
+// counts down minutes with a timer
+#ifdef USE_SUNSET_TIMER
+#define USE_TIMERS
 #endif
 
 // ensure the jump start feature gets compiled in if needed
@@ -262,7 +262,13 @@ uint8_t steady_state(Event event, uint16_t arg) {
 
     else if (event == EV_tick) {
         // un-reverse after 1 second
-        if (arg == AUTO_REVERSE_TIME) ramp_direction = 1;
+        if (arg >= AUTO_REVERSE_TIME) ramp_direction = 1;
+
+        #ifdef USE_ADAPTIVE_TICK
+        // nothing moves per-frame while steady, so the clock can slow down
+        // (unless a gradual adjustment is in progress, checked below)
+        uint8_t slow_ok = (arg > AUTO_REVERSE_TIME);
+        #endif
 
         #ifdef USE_SUNSET_TIMER
         // reduce output if shutoff timer is active
@@ -270,7 +276,7 @@ uint8_t steady_state(Event event, uint16_t arg) {
             uint8_t dimmed_level = sunset_timer_orig_level * sunset_timer / sunset_timer_peak;
             uint8_t dimmed_level_next = sunset_timer_orig_level * (sunset_timer-1) / sunset_timer_peak;
             uint8_t dimmed_level_delta = dimmed_level - dimmed_level_next;
-            dimmed_level -= dimmed_level_delta * (sunset_ticks/TICKS_PER_SECOND) / 60;
+            dimmed_level -= dimmed_level_delta * (sunset_ticks()/TICKS_PER_SECOND) / 60;
             if (dimmed_level < 1) dimmed_level = 1;
 
             #ifdef USE_SET_LEVEL_GRADUALLY
@@ -285,8 +291,11 @@ uint8_t steady_state(Event event, uint16_t arg) {
         #ifdef USE_SET_LEVEL_GRADUALLY
         int16_t diff = gradual_target - actual_level;
         static uint16_t ticks_since_adjust = 0;
-        ticks_since_adjust++;
+        ticks_since_adjust += tick_scale;
         if (diff) {
+            #ifdef USE_ADAPTIVE_TICK
+            slow_ok = 0;
+            #endif
             uint16_t ticks_per_adjust = 256;
             if (diff < 0) {
                 //diff = -diff;
@@ -312,6 +321,10 @@ uint8_t steady_state(Event event, uint16_t arg) {
             }
         }
         #endif  // ifdef USE_SET_LEVEL_GRADUALLY
+
+        #ifdef USE_ADAPTIVE_TICK
+        if (slow_ok) allow_slow_ticks();
+        #endif
         return EVENT_HANDLED;
     }
 
@@ -523,7 +536,7 @@ void ramp_config_save(uint8_t step, uint8_t value) {
     // simple UI config is weird...
     // has some ramp extras after floor/ceil/steps
     if (4 == step) {
-        cfg.ramp_2c_style_simple = value;
+        cfg.ramp_2c_style_simple = (value > 2) ? 2 : value;
     }
     else
     #endif
@@ -576,9 +589,6 @@ void ramp_extras_config_save(uint8_t step, uint8_t value) {
 
     #ifdef USE_MANUAL_MEMORY_TIMER
     // item 2: set manual memory timer duration
-    // FIXME: should be limited to (65535 / SLEEP_TICKS_PER_MINUTE)
-    //   to avoid overflows or impossibly long timeouts
-    //   (by default, the effective limit is 145, but it allows up to 255)
     else if (manual_memory_timer_config_step == step) {
         cfg.manual_memory_timer = value;
     }
@@ -589,7 +599,7 @@ void ramp_extras_config_save(uint8_t step, uint8_t value) {
     // 0 = yes, ramp after moon
     // 1+ = no, stay at moon
     else if (dont_ramp_after_moon_config_step == step) {
-        cfg.dont_ramp_after_moon = value;
+        cfg.dont_ramp_after_moon = (value > 0);
     }
     #endif
 
@@ -598,13 +608,13 @@ void ramp_extras_config_save(uint8_t step, uint8_t value) {
     // 1 = Anduril 1, 2C turbo
     // 2+ = Anduril 2, 2C ceiling
     else if (ramp_2c_style_config_step == step) {
-        cfg.ramp_2c_style = value;
+        cfg.ramp_2c_style = (value > 2) ? 2 : value;
     }
     #endif
 
     #ifdef USE_SMOOTH_STEPS
     else if (smooth_steps_style_config_step == step) {
-        cfg.smooth_steps_style = value;
+        cfg.smooth_steps_style = (value > 0);
     }
     #endif
 }
@@ -734,7 +744,7 @@ void reset_sunset_timer() {
     if (sunset_timer) {
         sunset_timer_orig_level = actual_level;
         sunset_timer_peak = sunset_timer;
-        sunset_ticks = 0;
+        sunset_minute_restart();
     }
 }
 #endif
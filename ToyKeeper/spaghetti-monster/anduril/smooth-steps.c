@@ -8,13 +8,14 @@
 
 #ifdef USE_SMOOTH_STEPS
 
-// one iteration of main loop()
-void smooth_steps_iter() {
+// one frame of the animation
+uint16_t smooth_steps_frame() {
     if (actual_level == smooth_steps_target) {
         set_level(smooth_steps_target);
-        smooth_steps_in_progress = 0;
+        anim_stop();
         // restore prev_level when animation ends
         prev_level = smooth_steps_start;
+        return 0;
     }
     else if (smooth_steps_target > actual_level) {
         // power-linear(ish) ascent
@@ -23,7 +24,7 @@ void smooth_steps_iter() {
         uint8_t this = diff / smooth_steps_speed;
         if (!this) this = 1;
         set_level(actual_level + this);
-        nice_delay_ms(10);
+        return 10;
     } else {
         // ramp-linear descent
         // (jump by 1 on each frame, frame rate gives constant total time)
@@ -31,16 +32,23 @@ void smooth_steps_iter() {
         uint16_t delay = 1 + (30 * smooth_steps_speed / diff);
         set_level(actual_level - 1);
         // TODO? if delay < one PWM cycle, this can look a little weird
-        nice_delay_ms(delay);
+        return delay;
     }
 }
 
+void smooth_steps_stop() {
+    anim_stop();
+    // leave the level where it is, but finish up like a completed step
+    prev_level = smooth_steps_start;
+}
+
 void set_level_smooth(uint8_t level, uint8_t speed) {
     smooth_steps_target = level;
     smooth_steps_speed = speed;  // higher = slower
-    smooth_steps_in_progress = 1;
     // for setting prev_level after animation ends
     smooth_steps_start = actual_level;
+    // keep going after a state change, like turning off
+    anim_start(smooth_steps_frame, ANIM_KEEP);
 }
 
 #endif
@@ -8,12 +8,14 @@
 
 uint8_t smooth_steps_start;
 uint8_t smooth_steps_target;
-uint8_t smooth_steps_in_progress;
 uint8_t smooth_steps_speed;
 
-void smooth_steps_iter();
+uint16_t smooth_steps_frame();
+#define smooth_steps_in_progress anim_playing(smooth_steps_frame)
 
 void set_level_smooth(uint8_t level, uint8_t speed);
+// cancel a step in progress, wherever it is
+void smooth_steps_stop();
 
 #endif
 
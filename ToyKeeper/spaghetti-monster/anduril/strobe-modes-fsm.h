@@ -23,6 +23,19 @@
 // so it's relevant for FSM configuration
 #if defined(USE_CANDLE_MODE) || defined(USE_BIKE_FLASHER_MODE) || defined(USE_PARTY_STROBE_MODE) || defined(USE_TACTICAL_STROBE_MODE) || defined(USE_LIGHTNING_MODE)
 #define USE_STROBE_STATE
+// most of them are animated in the background
+#define USE_ANIMATION
+#endif
+// ... and so is police strobe, in the "boring strobes" group
+#ifdef USE_POLICE_STROBE_MODE
+#define USE_ANIMATION
+#endif
+
+// party and tactical strobes use the hwdef's pulse timer, if it has one
+// (but it turns the output all the way off, so not if it should stay on
+//  between flashes)
+#if (defined(USE_PARTY_STROBE_MODE) || defined(USE_TACTICAL_STROBE_MODE)) && defined(PULSE_vect) && (! defined(STROBE_OFF_LEVEL))
+#define USE_PULSE
 #endif
 
 // internal numbering for strobe modes
@@ -40,6 +40,7 @@ uint8_t strobe_state(Event event, uint16_t arg) {
     // 2 clicks: rotate through strobe/flasher modes
     else if (event == EV_2clicks) {
         current_strobe_type = cfg.strobe_type = (st + 1) % NUM_STROBES;
+        anim_stop();  // start the new one right away
         save_config();
         return EVENT_HANDLED;
     }
@@ -56,6 +57,7 @@ uint8_t strobe_state(Event event, uint16_t arg) {
     // 4 clicks: rotate backward through strobe/flasher modes
     else if (event == EV_4clicks) {
         current_strobe_type = cfg.strobe_type = (st - 1 + NUM_STROBES) % NUM_STROBES;
+        anim_stop();  // start the new one right away
         save_config();
         return EVENT_HANDLED;
     }
@@ -154,7 +156,7 @@ uint8_t strobe_state(Event event, uint16_t arg) {
     // clock tick: bump the random seed
     else if (event == EV_tick) {
         // un-reverse after 1 second
-        if (arg == AUTO_REVERSE_TIME) ramp_direction = 1;
+        if (arg >= AUTO_REVERSE_TIME) ramp_direction = 1;
 
         pseudo_rand_seed += arg;
         return EVENT_HANDLED;
@@ -172,6 +174,11 @@ inline void strobe_state_iter() {
         channel_mode = cfg.strobe_channels[st];
     #endif
 
+    // most strobes are animations which keep going on their own,
+    // so only start one if nothing is playing yet
+    // (changing strobe types stops the old one)
+    if (anim_busy()) return;
+
     switch(st) {
         #if defined(USE_PARTY_STROBE_MODE) || defined(USE_TACTICAL_STROBE_MODE)
         #ifdef USE_PARTY_STROBE_MODE
@@ -180,25 +187,28 @@ inline void strobe_state_iter() {
         #ifdef USE_TACTICAL_STROBE_MODE
         case tactical_strobe_e:
         #endif
-            party_tactical_strobe_mode_iter(st);
+            party_strobe_lit = 0;
+            anim_start(party_tactical_strobe_frame, 0);
             break;
         #endif
 
         #ifdef USE_POLICE_COLOR_STROBE_MODE
         case police_color_strobe_e:
-            police_color_strobe_iter();
+            police_strobe_step = 0;
+            anim_start(police_color_strobe_frame, 0);
             break;
         #endif
 
         #ifdef USE_LIGHTNING_MODE
         case lightning_storm_e:
-            lightning_storm_iter();
+            lightning_phase = LIGHTNING_START;
+            anim_start(lightning_storm_frame, 0);
             break;
         #endif
 
         #ifdef USE_BIKE_FLASHER_MODE
         case bike_flasher_e:
-            bike_flasher_iter();
+            bike_flasher_start();
             break;
         #endif
     }
@@ -206,79 +216,109 @@ inline void strobe_state_iter() {
 #endif  // ifdef USE_STROBE_STATE
 
 #if defined(USE_PARTY_STROBE_MODE) || defined(USE_TACTICAL_STROBE_MODE)
-inline void party_tactical_strobe_mode_iter(uint8_t st) {
-    // one iteration of main loop()
+uint16_t party_tactical_strobe_frame() {
+    // alternate between a flash and a gap
+    uint8_t st = current_strobe_type;
     uint8_t del = cfg.strobe_delays[st];
-    // TODO: make tac strobe brightness configurable?
-    set_level(STROBE_BRIGHTNESS);
-    if (0) {}  // placeholder
-    #ifdef USE_PARTY_STROBE_MODE
-    else if (st == party_strobe_e) {  // party strobe
-        #ifdef PARTY_STROBE_ONTIME
-        nice_delay_ms(PARTY_STROBE_ONTIME);
-        #else
-        if (del < 42) delay_zero();
-        else nice_delay_ms(1);
+    if (! party_strobe_lit) {
+        // how long to flash, in ms (0 = as short as possible)
+        uint8_t on = del >> 1;  // tactical strobe
+        #ifdef USE_PARTY_STROBE_MODE
+        if (st == party_strobe_e) {  // party strobe
+            #ifdef PARTY_STROBE_ONTIME
+            on = PARTY_STROBE_ONTIME;
+            #else
+            on = (del < 42) ? 0 : 1;
+            #endif
+        }
         #endif
+
+        // TODO: make tac strobe brightness configurable?
+        #ifdef USE_PULSE
+        // a timer ends the flash at exactly the right time, and the
+        // output stays off until the next one, so there's no gap frame
+        // (long flashes are accurate enough without it)
+        if (on < 64) {
+            pulse_start(STROBE_BRIGHTNESS,
+                        on ? (on * 1000U) : PARTY_STROBE_PULSE_US);
+            return on + del;
+        }
+        #endif
+        set_level(STROBE_BRIGHTNESS);
+        party_strobe_lit = 1;
+        if (on) return on;
+        // really short flashes are done here instead of in a frame
+        delay_zero();
     }
-    #endif
-    #ifdef USE_TACTICAL_STROBE_MODE
-    else {  //tactical strobe
-        nice_delay_ms(del >> 1);
-    }
-    #endif
+    party_strobe_lit = 0;
     set_level(STROBE_OFF_LEVEL);
-    nice_delay_ms(del);  // no return check necessary on final delay
+    return del;
 }
 #endif
 
 #ifdef USE_POLICE_COLOR_STROBE_MODE
-inline void police_color_strobe_iter() {
-    // one iteration of main loop()
+uint16_t police_color_strobe_frame() {
+    // 5 flashes on one channel, then 5 on the other
     uint8_t del = 66;
-    // TODO: make police strobe brightness configurable
-    uint8_t bright = memorized_level;
-    //uint8_t channel = channel_mode;
-
-    for (uint8_t i=0; i<10; i++) {
-        if (0 == i) set_channel_mode(POLICE_COLOR_STROBE_CH1);
-        else if (5 == i) set_channel_mode(POLICE_COLOR_STROBE_CH2);
-        set_level(bright);
-        nice_delay_ms(del >> 1);
+    uint8_t step = police_strobe_step ++;
+
+    // restore the channel when done
+    // (strobe_state_iter() starts the next cycle)
+    if (step >= 20) {
+        channel_mode = cfg.channel_mode;
+        anim_stop();
+        return 0;
+    }
+
+    // even steps flash, odd steps are the gaps between
+    if (step & 1) {
         set_level(STROBE_OFF_LEVEL);
-        nice_delay_ms(del);
+        return del;
     }
 
-    // restore the channel when done
-    //set_channel_mode(channel);
-    channel_mode = cfg.channel_mode;
+    if (0 == step) set_channel_mode(POLICE_COLOR_STROBE_CH1);
+    else if (10 == step) set_channel_mode(POLICE_COLOR_STROBE_CH2);
+    // TODO: make police strobe brightness configurable
+    set_level(memorized_level);
+    return del >> 1;
 }
 #endif
 
 #ifdef USE_LIGHTNING_MODE
-inline void lightning_storm_iter() {
-    // one iteration of main loop()
-    int16_t brightness;
-    uint16_t rand_time;
+uint16_t lightning_storm_frame() {
+    int16_t brightness = lightning_brightness;
+    static uint8_t rand_time;
+    static uint8_t stepdown;
 
+    // start a new flash:
     // turn the emitter on at a random level,
     // for a random amount of time between 1ms and 32ms
-    //rand_time = 1 << (pseudo_rand() % 7);
-    rand_time = pseudo_rand() & 63;
-    brightness = 1 << (pseudo_rand() % 7);  // 1, 2, 4, 8, 16, 32, 64
-    brightness += 1 << (pseudo_rand() % 5);  // 2 to 80 now
-    brightness += pseudo_rand() % brightness;  // 2 to 159 now (w/ low bias)
-    if (brightness > MAX_LEVEL) brightness = MAX_LEVEL;
-    set_level(brightness);
-    nice_delay_ms(rand_time);
+    if (LIGHTNING_START == lightning_phase) {
+        //rand_time = 1 << (pseudo_rand() % 7);
+        rand_time = pseudo_rand() & 63;
+        brightness = 1 << (pseudo_rand() % 7);  // 1, 2, 4, 8, 16, 32, 64
+        brightness += 1 << (pseudo_rand() % 5);  // 2 to 80 now
+        brightness += pseudo_rand() % brightness;  // 2 to 159 now (w/ low bias)
+        if (brightness > MAX_LEVEL) brightness = MAX_LEVEL;
+        set_level(brightness);
+        stepdown = brightness >> 3;
+        if (stepdown < 1) stepdown = 1;
+        lightning_brightness = brightness;
+        lightning_phase = LIGHTNING_FADE;
+        // (the first step down waits twice as long)
+        return rand_time << 1;
+    }
 
+    // sometimes flicker down to half brightness between steps
+    if (LIGHTNING_DIP == lightning_phase) {
+        lightning_phase = LIGHTNING_FADE;
+        set_level(brightness>>1);
+    }
     // decrease the brightness somewhat more gradually, like lightning
-    uint8_t stepdown = brightness >> 3;
-    if (stepdown < 1) stepdown = 1;
-    while(brightness > 1) {
-        nice_delay_ms(rand_time);
+    else {
         brightness -= stepdown;
         if (brightness < 0) brightness = 0;
+        lightning_brightness = brightness;
         set_level(brightness);
         /*
            if ((brightness < MAX_LEVEL/2) && (! (pseudo_rand() & 15))) {
@@ -287,18 +327,20 @@ inline void lightning_storm_iter() {
            }
            */
         if (! (pseudo_rand() & 3)) {
-            nice_delay_ms(rand_time);
-            set_level(brightness>>1);
+            lightning_phase = LIGHTNING_DIP;
+            return rand_time;
         }
     }
+    if (brightness > 1) return rand_time;
 
     // turn the emitter off,
     // for a random amount of time between 1ms and 8192ms
     // (with a low bias)
-    rand_time = 1 << (pseudo_rand() % 13);
-    rand_time += pseudo_rand() % rand_time;
+    uint16_t off_time = 1 << (pseudo_rand() % 13);
+    off_time += pseudo_rand() % off_time;
     set_level(0);
-    nice_delay_ms(rand_time);  // no return check necessary on final delay
+    lightning_phase = LIGHTNING_START;
+    return off_time;
 }
 #endif
 
@@ -306,18 +348,24 @@ inline void lightning_storm_iter() {
 #ifndef BIKE_STROBE_ONTIME
 #define BIKE_STROBE_ONTIME 0
 #endif
-inline void bike_flasher_iter() {
-    // one iteration of main loop()
+AnimFrame bike_flasher_frames[8];
+inline void bike_flasher_start() {
+    // four quick bursts, then a longer pause at the steady level
     uint8_t burst = cfg.bike_flasher_brightness << 1;
     if (burst > MAX_LEVEL) burst = MAX_LEVEL;
+    AnimFrame *f = bike_flasher_frames;
     for(uint8_t i=0; i<4; i++) {
-        set_level(burst);
-        nice_delay_ms(5 + BIKE_STROBE_ONTIME);
-        set_level(cfg.bike_flasher_brightness);
-        nice_delay_ms(65);
+        f->level = burst;
+        f->ms = 5 + BIKE_STROBE_ONTIME;
+        f ++;
+        f->level = cfg.bike_flasher_brightness;
+        f->ms = 65;
+        f ++;
     }
-    nice_delay_ms(720);  // no return check necessary on final delay
-    set_level(0);
+    f[-1].ms += 720;
+    // strobe_state_iter() starts it again when it's done,
+    // so brightness changes apply to the next cycle
+    anim_play(bike_flasher_frames, 8, 0);
 }
 #endif
 
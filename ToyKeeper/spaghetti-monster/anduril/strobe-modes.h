@@ -35,28 +35,45 @@ strobe_mode_te current_strobe_type;
 #define STROBE_OFF_LEVEL 0
 #endif
 
+#ifdef USE_PULSE
+// the shortest party strobe flash, when a timer can do it
+// (about as long as delay_zero())
+#ifndef PARTY_STROBE_PULSE_US
+#define PARTY_STROBE_PULSE_US 500
+#endif
+#endif
+
 // party and tactical strobes
 #ifdef USE_STROBE_STATE
 uint8_t strobe_state(Event event, uint16_t arg);
 inline void strobe_state_iter();
 #endif
 
+// (each strobe's animation state is reset when it starts playing,
+//  so it always starts from the first frame)
 #if defined(USE_PARTY_STROBE_MODE) || defined(USE_TACTICAL_STROBE_MODE)
-inline void party_tactical_strobe_mode_iter(uint8_t st);
+uint8_t party_strobe_lit;  // 1 = in a flash, 0 = in a gap
+uint16_t party_tactical_strobe_frame();
 #endif
 
 #ifdef USE_POLICE_COLOR_STROBE_MODE
-inline void police_color_strobe_iter();
+uint8_t police_strobe_step;  // flash / gap number in this cycle
+uint16_t police_color_strobe_frame();
 #endif
 
 #ifdef USE_LIGHTNING_MODE
-inline void lightning_storm_iter();
+int16_t lightning_brightness;
+uint8_t lightning_phase;  // what the next frame does:
+#define LIGHTNING_START 0  // start a new flash
+#define LIGHTNING_FADE  1  // step the brightness down
+#define LIGHTNING_DIP   2  // flicker down to half, then keep fading
+uint16_t lightning_storm_frame();
 #endif
 
 // bike mode config options
 #ifdef USE_BIKE_FLASHER_MODE
 #define MAX_BIKING_LEVEL 120  // should be 127 or less
-inline void bike_flasher_iter();
+inline void bike_flasher_start();
 #endif
 
 #ifdef USE_CANDLE_MODE
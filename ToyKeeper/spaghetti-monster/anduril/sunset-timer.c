@@ -16,7 +16,20 @@ uint8_t sunset_timer_state(Event event, uint16_t arg) {
     // reset on start
     if (event == EV_enter_state) {
         sunset_timer = 0;
-        sunset_ticks = 0;
+        timer_stop(&sunset_minute);
+        return EVENT_HANDLED;
+    }
+    // stop counting when the mode is left, or it keeps waking the MCU
+    // (this happens when a menu opens on top of it too, so remember
+    //  where it was, and pick up from there after the menu)
+    else if (event == EV_leave_state) {
+        sunset_minute_left = timer_left(&sunset_minute);
+        timer_stop(&sunset_minute);
+        return EVENT_HANDLED;
+    }
+    else if (event == EV_reenter_state) {
+        if (sunset_timer)
+            timer_start(&sunset_minute, sunset_minute_left, TICKS_PER_MINUTE);
         return EVENT_HANDLED;
     }
     // hold: maybe "bump" the timer if it's active and almost expired
@@ -25,7 +38,7 @@ uint8_t sunset_timer_state(Event event, uint16_t arg) {
         if ((sunset_timer > 0) && (sunset_timer < 4)) {
             sunset_timer = 3;  // 3 minutes
             sunset_timer_peak = 3;
-            sunset_ticks = 0;  // re-start current "minute"
+            sunset_minute_restart();  // re-start current "minute"
         }
     }
     // 5H: add 5m to timer, per second, until released
@@ -35,24 +48,20 @@ uint8_t sunset_timer_state(Event event, uint16_t arg) {
                 // add a few minutes to the timer
                 sunset_timer += SUNSET_TIMER_UNIT;
                 sunset_timer_peak = sunset_timer;  // reset ceiling
-                sunset_ticks = 0;  // reset phase
+                sunset_minute_restart();  // reset phase
                 // let the user know something happened
                 blink_once();
             }
         }
         return EVENT_HANDLED;
     }
-    // tick: count down until time expires
-    else if (event == EV_tick) {
-        // time passed
-        sunset_ticks ++;
-        // did we reach a minute mark?
-        if (sunset_ticks >= TICKS_PER_MINUTE) {
-            sunset_ticks = 0;
-            if (sunset_timer > 0) {
-                sunset_timer --;
-            }
+    // a minute passed: count down until time expires
+    else if ((event == EV_timer) && (arg == TIMER_SUNSET)) {
+        if (sunset_timer > 0) {
+            sunset_timer --;
         }
+        // stop counting when it's done, or if it was cancelled
+        if (! sunset_timer) timer_stop(&sunset_minute);
         return EVENT_HANDLED;
     }
     return EVENT_NOT_HANDLED;
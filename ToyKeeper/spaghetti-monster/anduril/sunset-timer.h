@@ -7,11 +7,16 @@
 // how many minutes to add each time the user "bumps" the timer?
 #define SUNSET_TIMER_UNIT 5
 
-#define TICKS_PER_MINUTE (TICKS_PER_SECOND*60)
-
 // automatic shutoff timer
 uint8_t sunset_timer = 0;  // minutes remaining in countdown
 uint8_t sunset_timer_peak = 0;  // total minutes in countdown
-uint16_t sunset_ticks = 0;  // counts from 0 to TICKS_PER_MINUTE, then repeats
+Timer sunset_minute = { .id = TIMER_SUNSET };  // due once per minute
+uint16_t sunset_minute_left;  // ... and how much was left, during a menu
 uint8_t sunset_timer_state(Event event, uint16_t arg);
+// start counting a new minute
+#define sunset_minute_restart() timer_start(&sunset_minute, TICKS_PER_MINUTE, TICKS_PER_MINUTE)
+// how far into the current minute, from 0 to TICKS_PER_MINUTE
+// (or 0 if it's not counting)
+#define sunset_ticks() (timer_active(&sunset_minute) \
+        ? (TICKS_PER_MINUTE - timer_left(&sunset_minute)) : 0)
 
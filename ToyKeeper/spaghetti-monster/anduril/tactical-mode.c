@@ -43,6 +43,9 @@ uint8_t tactical_state(Event event, uint16_t arg) {
     // button was released
     else if ((event & (B_CLICK | B_PRESS)) == (B_CLICK)) {
         momentary_active = 0;
+        #ifdef USE_STROBE_STATE
+        anim_stop();
+        #endif
         set_level(0);
         interrupt_nice_delays();  // stop animations in progress
     }
@@ -26,6 +26,12 @@ inline void version_check_iter() {
         nice_delay_ms(300);
     }
 
+    #ifdef USE_LATENCY_PROBE
+    // then how long the last measured click took to reach the light
+    nice_delay_ms(1000);
+    latency_blink();
+    #endif
+
     set_state_deferred(off_state, 0);
 }
 
@@ -2376,11 +2376,4 @@ void loop() {
     }
     #endif
 
-    #ifdef USE_IDLE_MODE
-    else {
-        // doze until next clock tick
-        idle_mode();
-    }
-    #endif
-
 }
@@ -303,8 +303,12 @@ void adc_deferred() {
 #ifdef USE_LVP
 static inline void ADC_voltage_handler() {
     // rate-limit low-voltage warnings to a max of 1 per N seconds
+    #ifdef USE_TIMERS
+    static Timer lvp_timer;  // (id 0, it only needs to be checked)
+    #else
     static uint8_t lvp_timer = 0;
     #define LVP_TIMER_START (VOLTAGE_WARNING_SECONDS*ADC_CYCLES_PER_SECOND)  // N seconds between LVP warnings
+    #endif
 
     #ifdef NO_LVP_WHILE_BUTTON_PRESSED
     // don't run if button is currently being held
@@ -370,9 +374,13 @@ static inline void ADC_voltage_handler() {
 
     // if low, callback EV_voltage_low / EV_voltage_critical
     //         (but only if it has been more than N seconds since last call)
+    #ifdef USE_TIMERS
+    if (! timer_active(&lvp_timer)) {
+    #else
     if (lvp_timer) {
         lvp_timer --;
     } else {  // it has been long enough since the last warning
+    #endif
     	#ifdef DUAL_VOLTAGE_FLOOR
     	if (((voltage < VOLTAGE_LOW) && (voltage > DUAL_VOLTAGE_FLOOR)) || (voltage < DUAL_VOLTAGE_LOW_LOW)) {
     	#else
@@ -381,7 +389,11 @@ static inline void ADC_voltage_handler() {
             // send out a warning
             emit(EV_voltage_low, 0);
             // reset rate-limit counter
+            #ifdef USE_TIMERS
+            timer_start(&lvp_timer, VOLTAGE_WARNING_SECONDS*TICKS_PER_SECOND, 0);
+            #else
             lvp_timer = LVP_TIMER_START;
+            #endif
         }
     }
 }
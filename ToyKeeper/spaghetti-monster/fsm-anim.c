@@ -0,0 +1,94 @@
+// fsm-anim.c: Background animations for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "fsm-anim.h"
+
+void anim_start(AnimFunc *func, uint8_t flags) {
+    #ifdef MS_CLOCK_vect
+    cli();
+    #endif
+    anim_func = func;
+    anim_flags = flags;
+    // first frame happens at the next trip through the main loop
+    anim_left = 0;
+    #ifdef MS_CLOCK_vect
+    ms_clock_on();
+    sei();
+    #endif
+}
+
+// play back a list of frames, one per call
+uint16_t anim_next_frame() {
+    if (! anim_frames_left) { anim_stop(); return 0; }
+    anim_frames_left --;
+    const AnimFrame *f = anim_frames ++;
+    set_level(f->level);
+    return f->ms;
+}
+
+void anim_play(const AnimFrame *frames, uint8_t count, uint8_t flags) {
+    anim_frames = frames;
+    anim_frames_left = count;
+    anim_start(anim_next_frame, flags);
+}
+
+void anim_stop() {
+    // (the clock turns itself off, if nothing else is using it)
+    anim_func = NULL;
+}
+
+void anim_interrupt() {
+    if (! (anim_flags & ANIM_KEEP)) anim_stop();
+}
+
+#ifdef MS_CLOCK_vect
+// the ISR changes anim_left, so read it with interrupts off
+// (otherwise its two bytes could come from different ticks)
+static inline int16_t anim_time_left() {
+    cli();
+    int16_t left = anim_left;
+    sei();
+    return left;
+}
+#else
+#define anim_time_left() anim_left
+#endif
+
+void anim_run() {
+    AnimFunc *func = anim_func;  // avoid repeat access
+    if (! func) return;
+
+    #ifndef MS_CLOCK_vect
+    // no hardware clock, so pass the time here, 1 ms per trip through
+    // the main loop (like nice_delay_ms(), but events are handled
+    // between steps by the main loop instead of from inside a delay)
+    if (anim_left > 0) {
+        nice_delay_1ms();
+        anim_left --;
+    }
+    #ifdef USE_IDLE_MODE
+    loop_busy = 1;  // don't doze between animation frames
+    #endif
+    #endif
+
+    // not time yet
+    if (anim_time_left() > 0) return;
+
+    uint16_t ms = func();
+    // the frame function may have started a different animation
+    // or stopped this one, so only continue if it's still running
+    if (anim_func != func) return;
+
+    // add to the time instead of setting it, so a late frame doesn't
+    // push back all the frames after it
+    #ifdef MS_CLOCK_vect
+    cli();
+    #endif
+    anim_left += ms;
+    #ifdef MS_CLOCK_vect
+    sei();
+    #endif
+}
@@ -0,0 +1,79 @@
+// fsm-anim.h: Background animations for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/*
+ * Plays a sequence of brightness changes over time, without blocking.
+ * Instead of a UI's loop() calling set_level() and nice_delay_ms() over
+ * and over, a mode starts an animation and returns.  The main loop
+ * advances it between events, so events are never handled from inside
+ * a delay, and a state change can't happen halfway through a frame.
+ *
+ * There are two kinds:
+ *   anim_play(frames, count, flags)
+ *       Steps through a list of AnimFrame {level, ms}, then stops.
+ *   anim_start(func, flags)
+ *       Calls func() for each frame.  It sets the output however it
+ *       wants, and returns how many ms to wait before the next call.
+ *       It can call anim_stop() when it's finished, or just keep going
+ *       until something else stops it.
+ *
+ * anim_stop() ends it early.  Changing states does too, unless it was
+ * started with ANIM_KEEP (for things like a brightness transition,
+ * which should finish even if the UI moves to another state).
+ *
+ * Timing:
+ *   Frame times add up exactly; if a frame starts late, the next one
+ *   is shortened to catch up.  The clock comes from one of two places:
+ *
+ *   - A hardware timer, if the hwdef provides one (see fsm-clock.h).
+ *     The interrupt is only enabled while an animation is playing (or a
+ *     delay is waiting), and the main loop can doze (USE_IDLE_MODE)
+ *     between frames.  The ISR only decrements a counter, so it costs
+ *     a few dozen cycles per ms.
+ *
+ *   - Otherwise, the main loop waits 1 ms at a time, the same way
+ *     nice_delay_ms() does, and doesn't doze until the animation ends.
+ *
+ *   The attiny1634 hwdefs which don't use timer0 for PWM provide a
+ *   clock on it (see fsm-clock.h for the list).  Every other target
+ *   uses the 1 ms fallback, which keeps the CPU awake for the whole
+ *   animation, and its frame times are only as accurate as the
+ *   calibrated delay loop.  The attiny 1-series could use TCB0 in
+ *   periodic interrupt mode, but that needs testing on hardware first.
+ *   The attiny85 has no spare timer while PWM is running.
+ */
+
+// one step of an animation: go to this level, wait this long
+typedef struct AnimFrame {
+    uint8_t level;
+    uint16_t ms;
+} AnimFrame;
+
+// sets up the next frame and returns how long to show it
+// (0 = call again on the next trip through the main loop)
+typedef uint16_t AnimFunc();
+
+// flags for anim_start() and anim_play()
+#define ANIM_KEEP  1  // keep playing after a state change
+
+AnimFunc *anim_func = NULL;
+uint8_t anim_flags;
+const AnimFrame *anim_frames;
+uint8_t anim_frames_left;
+uint16_t anim_next_frame();
+// ms until the next frame (negative when behind schedule)
+volatile int16_t anim_left;
+
+#define anim_busy() (anim_func != NULL)
+#define anim_playing(func) (anim_func == (func))
+
+void anim_start(AnimFunc *func, uint8_t flags);
+void anim_play(const AnimFrame *frames, uint8_t count, uint8_t flags);
+void anim_stop();
+// stop, unless the animation should survive a state change
+void anim_interrupt();
+// called by the main loop, to advance to the next frame when it's time
+void anim_run();
@@ -25,7 +25,29 @@ void set_channel_mode(uint8_t mode) {
 #endif  // if NUM_CHANNEL_MODES > 1
 
 
+#if defined(USE_CALC_2CH_BLEND) || defined(USE_CALC_AUTO_3CH_BLEND)
+// multiply by a blend coefficient (see BLEND_COEF), with rounding
+static inline PWM_DATATYPE blend_mul(PWM_DATATYPE2 x, uint16_t coef) {
+    return (((uint32_t)x * coef) + 0x4000) >> 15;
+}
+#endif
+
+
 #ifdef USE_CALC_2CH_BLEND
+// calculate the parts of a blend which don't depend on brightness
+// (only needs to happen when the blend changes)
+void calc_2ch_blend_coefs(uint8_t blend) {
+    blend_coefs.blend = blend;
+    blend_coefs.cool  = BLEND_COEF(blend);
+    #if TINT_RAMPING_CORRECTION > 0
+        // (TINT_RAMPING_CORRECTION / 64) * (triangle_wave(blend) / 255),
+        // as 0.16 fixed-point, because 65536 / (64 * 255) is very close
+        // to 4 + (1/64)
+        uint16_t boost = TINT_RAMPING_CORRECTION * triangle_wave(blend);
+        blend_coefs.boost = (boost << 2) + (boost >> 6);
+    #endif
+}
+
 // calculate a "tint ramp" blend between 2 channels
 // results are placed in *warm and *cool vars
 // brightness : total amount of light units to distribute
@@ -38,39 +60,32 @@ void calc_2ch_blend(
     PWM_DATATYPE top,
     uint8_t blend) {
 
-    #ifndef TINT_RAMPING_CORRECTION
-    #define TINT_RAMPING_CORRECTION 26  // 140% brightness at middle tint
-    #endif
+    if (blend != blend_coefs.blend) calc_2ch_blend_coefs(blend);
 
     // calculate actual PWM levels based on a single-channel ramp
     // and a blend value
     PWM_DATATYPE warm_PWM, cool_PWM;
     PWM_DATATYPE2 base_PWM = brightness;
 
-    #if defined(TINT_RAMPING_CORRECTION) && (TINT_RAMPING_CORRECTION > 0)
+    #if TINT_RAMPING_CORRECTION > 0
         uint8_t level = actual_level - 1;
 
         // middle tints sag, so correct for that effect
         // by adding extra power which peaks at the middle tint
         // (correction is only necessary when PWM is fast)
         if (level > HALFSPEED_LEVEL) {
-            base_PWM = brightness
-                     + ((((PWM_DATATYPE2)brightness) * TINT_RAMPING_CORRECTION / 64)
-                        * triangle_wave(blend) / 255);
+            base_PWM += ((uint32_t)brightness * blend_coefs.boost) >> 16;
         }
         // fade the triangle wave out when above 100% power,
         // so it won't go over 200%
         if (brightness > top) {
-            base_PWM -= 2 * (
-                             ((brightness - top) * TINT_RAMPING_CORRECTION / 64)
-                             * triangle_wave(blend) / 255
-                        );
+            base_PWM -= 2 * (((uint32_t)(brightness - top) * blend_coefs.boost) >> 16);
         }
         // guarantee no more than 200% power
         if (base_PWM > (top << 1)) { base_PWM = top << 1; }
     #endif
 
-    cool_PWM = (((PWM_DATATYPE2)blend * (PWM_DATATYPE2)base_PWM) + 127) / 255;
+    cool_PWM = blend_mul(base_PWM, blend_coefs.cool);
     warm_PWM = base_PWM - cool_PWM;
     // when running at > 100% power, spill extra over to other channel
     if (cool_PWM > top) {
@@ -87,7 +102,66 @@ void calc_2ch_blend(
 #endif  // ifdef USE_CALC_2CH_BLEND
 
 
+#ifdef USE_CALC_AUTO_3CH_BLEND
+// calculate a 3-channel "auto tint" blend
+// (like red -> warm white -> cool white)
+// results are placed in *a, *b, and *c vars
+// level : ramp level to convert into 3 channel levels
+// (assumes ramp table is "pwm1_levels")
+void calc_auto_3ch_blend(
+    PWM_DATATYPE *a,
+    PWM_DATATYPE *b,
+    PWM_DATATYPE *c,
+    uint8_t level) {
+
+    PWM_DATATYPE vpwm = PWM_GET(pwm1_levels, level);
+
+    // tint goes from 0 (red) to 127 (warm white) to 255 (cool white)
+    // (255 * (level+1) / RAMP_SIZE, within 1, without dividing)
+    uint8_t mytint = ((uint16_t)(level+1) * AUTO_3CH_TINT_STEP) >> 8;
+    uint8_t middle = triangle_wave(mytint);
+
+    #ifdef AUTO_3CH_BLEND_LINEAR
+    // red is high at 0, low at 255 (linear)
+    uint8_t falling = 255 - mytint;
+    // cool white is low at 0, high at 255 (linear)
+    uint8_t rising = mytint;
+    #else
+    // red fades out in the bottom half, cool white fades in at the top
+    uint8_t falling = 0, rising = 0;
+    if (level < (RAMP_SIZE/2)) falling = 255 - middle;
+    else rising = 255 - middle;
+    #endif
+
+    *a = blend_mul(vpwm, BLEND_COEF(falling));
+    // warm white is low at 0 and 255, high at 127 (linear triangle)
+    // (the d4k-3ch used to round this one down, and now it rounds to
+    //  nearest like the others, so it can be 1 higher on some levels)
+    *b = blend_mul(vpwm, BLEND_COEF(middle));
+    *c = blend_mul(vpwm, BLEND_COEF(rising));
+}
+#endif  // ifdef USE_CALC_AUTO_3CH_BLEND
+
+
 #ifdef USE_HSV2RGB
+// cosine crossfade between hues, (1 - cos(pi * x/16)) / 2, for x = 0 to 16
+// (looks smoother than a linear fade, because it eases in and out
+//  of each primary color instead of turning sharply there)
+PROGMEM const uint8_t hsv_fade[] = {
+    0, 2, 10, 21, 37, 57, 79, 103, 127, 152, 176, 198, 218, 234, 245, 253, 255
+};
+
+// v * x / 255, with two 8x8 multiplies instead of a divide
+// (p/255 is very close to (p + p/256) / 256, and p = hi*256 + lo,
+//  so this is (p + (p >> 8) + 128) >> 8 without any 32-bit multiply)
+static inline uint16_t hsv_scale(uint16_t v, uint8_t x) {
+    uint16_t hi = (uint16_t)(uint8_t)(v >> 8) * x;
+    uint16_t lo = (uint16_t)(uint8_t)v * x;
+    // (can carry past 16 bits, but it's only an add)
+    uint32_t sum = (uint32_t)lo + hi + (lo >> 8) + 128;
+    return hi + (uint16_t)(sum >> 8);
+}
+
 RGB_t hsv2rgb(uint8_t h, uint8_t s, uint16_t v) {
     RGB_t color;
 
@@ -96,23 +170,26 @@ RGB_t hsv2rgb(uint8_t h, uint8_t s, uint16_t v) {
         return color;
     }
 
-    uint8_t region;
-    uint16_t fpart;
+    uint8_t region, fpart, fade, i;
     uint16_t high, low, rising, falling;
 
     // hue has 6 segments, 0-5
     region = ((uint16_t)h * 6) >> 8;
     // find remainder part, make it from 0-255
-    fpart = ((uint16_t)h * 6) - (region << 8);
+    fpart = (uint8_t)(h * 6);
+
+    // look up the crossfade, and interpolate between table entries
+    i = fpart >> 4;
+    fade = pgm_read_byte(hsv_fade + i);
+    fade += ((uint8_t)(pgm_read_byte(hsv_fade + i + 1) - fade) * (fpart & 15)) >> 4;
 
-    // calculate graph segments, doing integer multiplication
-    // TODO: calculate 16-bit results, not 8-bit
+    // calculate graph segments at full 16-bit resolution
+    // (rising and falling add up to high + low, so the total stays even)
     high    = v;
-    low     = ((uint32_t)v * (255 - s)) >> 8;
-    // TODO: use a cosine crossfade instead of linear
-    // (because it looks better and feels more natural)
-    falling = ((uint32_t)v * (255 - ((s * fpart) >> 8))) >> 8;
-    rising  = ((uint32_t)v * (255 - ((s * (255 - fpart)) >> 8))) >> 8;
+    low     = hsv_scale(v, 255 - s);
+    rising  = hsv_scale(high - low, fade);
+    falling = high - rising;
+    rising += low;
 
     // default floor
     color.r = low;
@@ -161,22 +238,52 @@ RGB_t hsv2rgb(uint8_t h, uint8_t s, uint16_t v) {
 ///// Common set_level_*() functions shared by multiple lights /////
 // (unique lights should use their own,
 //  but these common versions cover most of the common hardware designs)
+// Power channels are stacked from lowest to highest power, on CH1_PWM,
+// CH2_PWM, and CH3_PWM, with ramps from PWM1_LEVELS, PWM2_LEVELS, and
+// PWM3_LEVELS.  If PWM_TOPS is defined, they also use dynamic PWM, with
+// a different TOP at each level, for finer low modes and a faster PWM
+// frequency down low.  If CH1_ENABLE_PIN is defined, they turn it on
+// (like for an opamp), and the hwdef's set_level_zero() turns it off.
+
+
+#if defined(USE_SET_LEVEL_1CH) || defined(USE_SET_LEVEL_2CH_STACKED) || defined(USE_SET_LEVEL_3CH_STACKED)
+#ifdef PWM_TOPS
+// pulse frequency modulation, a.k.a. dynamic PWM
+// (call this after setting the new PWM values)
+void set_level_pwm_top(uint8_t level) {
+    uint16_t top = PWM_GET16(pwm_tops, level);
+    if (actual_level) {
+        // change TOP at the timer's next TOP, to avoid flashes
+        set_pwm_top(top);
+    } else {
+        // force reset phase when turning on from zero
+        // (because otherwise the initial response is inconsistent)
+        set_pwm_top_now(top);
+        PWM_CNT = 0;
+    }
+}
+#else
+#define set_level_pwm_top(level)
+#endif
 
-// TODO: upgrade some older lights to dynamic PWM
-// TODO: 1ch w/ dynamic PWM
-// TODO: 1ch w/ dynamic PWM and opamp enable pins?
-// TODO: 2ch stacked w/ dynamic PWM
-// TODO: 2ch stacked w/ dynamic PWM and opamp enable pins?
+#ifdef CH1_ENABLE_PIN
+#define set_level_enable()  CH1_ENABLE_PORT |= (1 << CH1_ENABLE_PIN)
+#else
+#define set_level_enable()
+#endif
+#endif
 
 
 #ifdef USE_SET_LEVEL_1CH
 // single set of LEDs with 1 power channel
 void set_level_1ch(uint8_t level) {
-    if (level == 0) {
-        LOW_PWM_LVL  = 0;
-    } else {
-        level --;  // PWM array index = level - 1
-        LOW_PWM_LVL  = PWM_GET(low_pwm_levels, level);
+    set_level_enable();
+
+    PWM_DATATYPE ch1_pwm = PWM_GET(pwm1_levels, level);
+
+    PWM_ATOMIC {
+        CH1_PWM = ch1_pwm;
+        set_level_pwm_top(level);
     }
 }
 #endif
@@ -185,13 +292,15 @@ void set_level_1ch(uint8_t level) {
 #ifdef USE_SET_LEVEL_2CH_STACKED
 // single set of LEDs with 2 stacked power channels, DDFET+1 or DDFET+linear
 void set_level_2ch_stacked(uint8_t level) {
-    if (level == 0) {
-        LOW_PWM_LVL  = 0;
-        HIGH_PWM_LVL = 0;
-    } else {
-        level --;  // PWM array index = level - 1
-        LOW_PWM_LVL  = PWM_GET(low_pwm_levels,  level);
-        HIGH_PWM_LVL = PWM_GET(high_pwm_levels, level);
+    set_level_enable();
+
+    PWM_DATATYPE ch1_pwm = PWM_GET(pwm1_levels, level);
+    PWM_DATATYPE ch2_pwm = PWM_GET(pwm2_levels, level);
+
+    PWM_ATOMIC {
+        CH1_PWM = ch1_pwm;
+        CH2_PWM = ch2_pwm;
+        set_level_pwm_top(level);
     }
 }
 #endif
@@ -200,15 +309,17 @@ void set_level_2ch_stacked(uint8_t level) {
 #ifdef USE_SET_LEVEL_3CH_STACKED
 // single set of LEDs with 3 stacked power channels, like DDFET+N+1
 void set_level_3ch_stacked(uint8_t level) {
-    if (level == 0) {
-        LOW_PWM_LVL  = 0;
-        MED_PWM_LVL  = 0;
-        HIGH_PWM_LVL = 0;
-    } else {
-        level --;  // PWM array index = level - 1
-        LOW_PWM_LVL  = PWM_GET(low_pwm_levels,  level);
-        MED_PWM_LVL  = PWM_GET(med_pwm_levels,  level);
-        HIGH_PWM_LVL = PWM_GET(high_pwm_levels, level);
+    set_level_enable();
+
+    PWM_DATATYPE ch1_pwm = PWM_GET(pwm1_levels, level);
+    PWM_DATATYPE ch2_pwm = PWM_GET(pwm2_levels, level);
+    PWM_DATATYPE ch3_pwm = PWM_GET(pwm3_levels, level);
+
+    PWM_ATOMIC {
+        CH1_PWM = ch1_pwm;
+        CH2_PWM = ch2_pwm;
+        CH3_PWM = ch3_pwm;
+        set_level_pwm_top(level);
     }
 }
 #endif
@@ -299,59 +410,75 @@ void set_level_2ch_blend() {
 #endif  // ifdef USE_TINT_RAMPING
 
 
-#ifdef USE_GRADUAL_TICK_1CH
-void gradual_tick_1ch() {
-    GRADUAL_TICK_SETUP();
+#ifdef USE_SET_LEVEL_GRADUALLY
+#if defined(USE_SET_LEVEL_2CH_STACKED) || defined(USE_SET_LEVEL_3CH_STACKED)
+// lower channels are "full on" at this value
+// (gradual adjustments only happen where TOP is at its initial value)
+#ifdef PWM_TOP_INIT
+#define STACKED_FULL_PWM PWM_TOP_INIT
+#else
+#define STACKED_FULL_PWM PWM_TOP
+#endif
+#endif
+
+#ifdef USE_SET_LEVEL_1CH
+bool gradual_tick_1ch(uint8_t gt) {
+    PWM_DATATYPE pwm1 = PWM_GET(pwm1_levels, gt);
+
+    bool done;
 
-    GRADUAL_ADJUST_1CH(low_pwm_levels, LOW_PWM_LVL);
+    PWM_ATOMIC {
+        GRADUAL_ADJUST_SIMPLE(pwm1, CH1_PWM);
 
-    // did we go far enough to hit the next defined ramp level?
-    // if so, update the main ramp level tracking var
-    if ((LOW_PWM_LVL  == PWM_GET(low_pwm_levels,  gt)))
-    {
-        GRADUAL_IS_ACTUAL();
+        done = (   (pwm1 == CH1_PWM)
+               );
     }
+    return done;
 }
 #endif
 
 
-#ifdef USE_GRADUAL_TICK_2CH_STACKED
-void gradual_tick_2ch_stacked() {
-    GRADUAL_TICK_SETUP();
+#ifdef USE_SET_LEVEL_2CH_STACKED
+bool gradual_tick_2ch_stacked(uint8_t gt) {
+    PWM_DATATYPE pwm1 = PWM_GET(pwm1_levels, gt);
+    PWM_DATATYPE pwm2 = PWM_GET(pwm2_levels, gt);
+
+    bool done;
 
-    GRADUAL_ADJUST(low_pwm_levels, LOW_PWM_LVL, PWM_TOP);
-    GRADUAL_ADJUST_1CH(high_pwm_levels, HIGH_PWM_LVL);
+    PWM_ATOMIC {
+        GRADUAL_ADJUST_STACKED(pwm1, CH1_PWM, STACKED_FULL_PWM);
+        GRADUAL_ADJUST_SIMPLE (pwm2, CH2_PWM);
 
-    // did we go far enough to hit the next defined ramp level?
-    // if so, update the main ramp level tracking var
-    if (   (LOW_PWM_LVL  == PWM_GET(low_pwm_levels,  gt))
-        && (HIGH_PWM_LVL == PWM_GET(high_pwm_levels, gt))
-       )
-    {
-        GRADUAL_IS_ACTUAL();
+        done = (   (pwm1 == CH1_PWM)
+                && (pwm2 == CH2_PWM)
+               );
     }
+    return done;
 }
 #endif
 
 
-#ifdef USE_GRADUAL_TICK_3CH_STACKED
-void gradual_tick_3ch_stacked() {
-    GRADUAL_TICK_SETUP();
-
-    GRADUAL_ADJUST(low_pwm_levels, LOW_PWM_LVL, PWM_TOP);
-    GRADUAL_ADJUST(med_pwm_levels, MED_PWM_LVL, PWM_TOP);
-    GRADUAL_ADJUST_1CH(high_pwm_levels, HIGH_PWM_LVL);
-
-    // did we go far enough to hit the next defined ramp level?
-    // if so, update the main ramp level tracking var
-    if (   (LOW_PWM_LVL  == PWM_GET(low_pwm_levels,  gt))
-        && (MED_PWM_LVL  == PWM_GET(med_pwm_levels,  gt))
-        && (HIGH_PWM_LVL == PWM_GET(high_pwm_levels, gt))
-        )
-    {
-        GRADUAL_IS_ACTUAL();
+#ifdef USE_SET_LEVEL_3CH_STACKED
+bool gradual_tick_3ch_stacked(uint8_t gt) {
+    PWM_DATATYPE pwm1 = PWM_GET(pwm1_levels, gt);
+    PWM_DATATYPE pwm2 = PWM_GET(pwm2_levels, gt);
+    PWM_DATATYPE pwm3 = PWM_GET(pwm3_levels, gt);
+
+    bool done;
+
+    PWM_ATOMIC {
+        GRADUAL_ADJUST_STACKED(pwm1, CH1_PWM, STACKED_FULL_PWM);
+        GRADUAL_ADJUST_STACKED(pwm2, CH2_PWM, STACKED_FULL_PWM);
+        GRADUAL_ADJUST_SIMPLE (pwm3, CH3_PWM);
+
+        done = (   (pwm1 == CH1_PWM)
+                && (pwm2 == CH2_PWM)
+                && (pwm3 == CH3_PWM)
+               );
     }
+    return done;
 }
 #endif
+#endif  // ifdef USE_SET_LEVEL_GRADUALLY
 
 
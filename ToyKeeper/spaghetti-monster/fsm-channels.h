@@ -85,7 +85,48 @@ StatePtr channel_3H_modes[NUM_CHANNEL_MODES];
 void set_channel_mode(uint8_t mode);
 #endif
 
+/*
+ * Blend functions avoid dividing by 255 for each level, because none of
+ * these MCUs have a divide instruction, so libgcc does it in a loop.
+ * Instead, each channel gets one 16-bit x 16-bit multiply by a
+ * fixed-point coefficient, and 2-channel coefficients are only
+ * calculated when the blend changes.
+ *
+ * Rough estimates, not measured: counting libgcc's loops, a 32-bit
+ * divide is about 700 cycles.  The attiny85 and attiny1634 also have no
+ * multiply instruction, and there a multiply is about 17 cycles per bit
+ * of one operand.  So on those, a 2-channel blend went from about 1100
+ * cycles per call to about 300, or 2500 to 600 with
+ * TINT_RAMPING_CORRECTION, and a 3-channel auto blend from about 3300
+ * to 1000.  That's roughly 0.1 to 0.3 ms per set_level() or
+ * gradual_tick() at 8 MHz.  The attiny 1-series (like the t1616 in the
+ * LT1S Pro) has a hardware MUL, so multiplies are cheap there and the
+ * savings are mostly the skipped divides.
+ */
+
+// x / 255, as 1.15 fixed-point (so 255 becomes exactly 1.0)
+#define BLEND_COEF(x) (((uint16_t)(x) * 257 + 1) >> 1)
+
 #ifdef USE_CALC_2CH_BLEND
+#ifndef TINT_RAMPING_CORRECTION
+#define TINT_RAMPING_CORRECTION 26  // 140% brightness at middle tint
+#endif
+#if TINT_RAMPING_CORRECTION > 64
+#error TINT_RAMPING_CORRECTION must be 0 to 64.
+#endif
+
+// per-blend values for calc_2ch_blend()
+// (all zeroes is correct for blend 0, so it starts out valid)
+typedef struct blend_coefs_t {
+    uint8_t blend;   // which blend these are for
+    uint16_t cool;   // blend / 255, 1.15 fixed-point
+    #if TINT_RAMPING_CORRECTION > 0
+    uint16_t boost;  // extra power at this blend, 0.16 fixed-point
+    #endif
+} blend_coefs_t;
+blend_coefs_t blend_coefs;
+
+void calc_2ch_blend_coefs(uint8_t blend);
 void calc_2ch_blend(
     PWM_DATATYPE *warm,
     PWM_DATATYPE *cool,
@@ -94,29 +135,47 @@ void calc_2ch_blend(
     uint8_t blend);
 #endif
 
+#ifdef USE_CALC_AUTO_3CH_BLEND
+// 255 / RAMP_SIZE, as 8.8 fixed-point (rounded up, so the top is 255)
+#define AUTO_3CH_TINT_STEP ((255UL * 256 + RAMP_SIZE - 1) / RAMP_SIZE)
+// AUTO_3CH_BLEND_LINEAR: fade the 1st and 3rd channels over the whole
+// ramp, instead of only the bottom and top halves
+void calc_auto_3ch_blend(
+    PWM_DATATYPE *a,
+    PWM_DATATYPE *b,
+    PWM_DATATYPE *c,
+    uint8_t level);
+#endif
+
 #ifdef USE_HSV2RGB
 typedef struct RGB_t {
     uint16_t r;
     uint16_t g;
     uint16_t b;
 } RGB_t;
+// h: hue, s: saturation, v: brightness (full 16-bit range)
+// (uses a table for a cosine crossfade, and only 8x8 multiplies, five
+//  of them, instead of 32-bit math...  roughly 600 cycles instead of
+//  1100 on MUL-less attinys, estimated by counting libgcc's loops,
+//  not measured)
 RGB_t hsv2rgb(uint8_t h, uint8_t s, uint16_t v);
 #endif  // ifdef USE_HSV2RGB
 
 
+// common set_level / gradual_tick functions, see fsm-channels.c
 #ifdef USE_SET_LEVEL_1CH
-// TODO: remove this
 void set_level_1ch(uint8_t level);
+bool gradual_tick_1ch(uint8_t gt);
 #endif
 
 #ifdef USE_SET_LEVEL_2CH_STACKED
-// TODO: remove this
 void set_level_2ch_stacked(uint8_t level);
+bool gradual_tick_2ch_stacked(uint8_t gt);
 #endif
 
 #ifdef USE_SET_LEVEL_3CH_STACKED
-// TODO: remove this
 void set_level_3ch_stacked(uint8_t level);
+bool gradual_tick_3ch_stacked(uint8_t gt);
 #endif
 
 #if defined(USE_TINT_RAMPING) && (!defined(TINT_RAMP_TOGGLE_ONLY))
@@ -124,18 +183,3 @@ void set_level_3ch_stacked(uint8_t level);
 void set_level_2ch_blend();
 #endif
 
-#ifdef USE_GRADUAL_TICK_1CH
-// TODO: remove this
-void gradual_tick_1ch();
-#endif
-
-#ifdef USE_GRADUAL_TICK_2CH_STACKED
-// TODO: remove this
-void gradual_tick_2ch_stacked();
-#endif
-
-#ifdef USE_GRADUAL_TICK_3CH_STACKED
-// TODO: remove this
-void gradual_tick_3ch_stacked();
-#endif
-
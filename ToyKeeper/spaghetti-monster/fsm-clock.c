@@ -0,0 +1,62 @@
+// fsm-clock.c: Millisecond clock for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <util/atomic.h>
+
+#include "fsm-clock.h"
+
+uint16_t ms_clock_now() {
+    uint16_t now;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        now = ms_clock_ticks;
+    }
+    return now;
+}
+
+void ms_clock_wait(uint16_t until) {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    // check with interrupts off, so the tick can't sneak in before
+    // sleep_cpu()  (the instruction after sei() always runs first)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        while ((int16_t)(ms_clock_ticks - until) < 0) {
+            ms_clock_waiting = 1;
+            ms_clock_on();
+            sleep_enable();
+            sei();
+            sleep_cpu();  // wait for the clock, or any other interrupt
+            sleep_disable();
+            cli();
+        }
+        ms_clock_waiting = 0;
+    }
+}
+
+ISR(MS_CLOCK_vect) {
+    #ifdef MS_CLOCK_INTFLAGS
+    MS_CLOCK_INTFLAGS = MS_CLOCK_INT_bm;
+    #endif
+
+    #if defined(USE_DYNAMIC_UNDERCLOCKING) && (! defined(AVRXMEGA3))
+    // the timer slows down when the MCU does, so each tick is longer
+    // (on 1-series MCUs, use the RTC instead, which doesn't slow down)
+    uint8_t ms = 1 << (CLKPR & 0x0f);
+    #else
+    #define ms 1
+    #endif
+
+    ms_clock_ticks += ms;
+
+    #ifdef USE_ANIMATION
+    // count down to the next frame
+    anim_left -= ms;
+    if (anim_busy()) return;
+    #endif
+
+    // nothing else needs the clock, so let the MCU doze
+    if (! ms_clock_waiting) MS_CLOCK_INTCTRL &= ~MS_CLOCK_INT_bm;
+
+    #undef ms
+}
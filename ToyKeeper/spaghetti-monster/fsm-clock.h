@@ -0,0 +1,55 @@
+// fsm-clock.h: Millisecond clock for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/*
+ * A 1 kHz timer interrupt, for things which need to measure time more
+ * finely than WDT ticks:
+ *   - nice_delay_ms() and delay_4ms() sleep until enough ms have passed,
+ *     instead of counting CPU cycles in a busy loop
+ *   - animations (fsm-anim.h) count down to the next frame
+ *
+ * The hwdef provides it, if it has a spare timer:
+ *   MS_CLOCK_vect      an interrupt which fires once per ms
+ *   MS_CLOCK_INTCTRL   the register which enables it
+ *   MS_CLOCK_INT_bm    ... and the bit to set there
+ *   MS_CLOCK_INTFLAGS  (attiny 1-series only) where to clear the flag
+ * ... and sets up the timer in hwdef_setup().
+ *
+ * The interrupt is only enabled while something needs it; the ISR turns
+ * itself off after that, so the MCU can doze between WDT ticks again.
+ * The timer runs on the CPU clock, so when the MCU is underclocked, each
+ * interrupt counts as several ms.  Delays and animations run at full
+ * speed, so that's only a fallback.
+ *
+ * Without a hwdef clock, delays use calibrated busy loops instead.
+ * The attiny1634 hwdefs which leave timer0 free for it have one (Emisar
+ * D4v2, and the Noctigon KR4, K1, DM11, M44, and FW3X families).  On the
+ * attiny85 and the 1-series, and on 1634 drivers which use timer0 for
+ * PWM, beacon, SOS, strobes, and other blinky modes still spin the CPU
+ * between flashes.
+ */
+
+// counts up once per ms, wrapping around after about 65 seconds
+// (use ms_clock_now() to read it outside the ISR)
+volatile uint16_t ms_clock_ticks;
+// a delay is waiting for the clock
+volatile uint8_t ms_clock_waiting;
+
+// make sure the interrupt is running
+// (it stops on its own when nothing needs it)
+#define ms_clock_on()  (MS_CLOCK_INTCTRL |= MS_CLOCK_INT_bm)
+
+// read ms_clock_ticks without the ISR changing it halfway through
+uint16_t ms_clock_now();
+
+// sleep until ms_clock_ticks reaches 'until'
+// (returns right away if it's already there, or up to 32 seconds past it)
+// Delays add to their last 'until' instead of reading the clock again,
+// so time spent between waits doesn't add up.  Only the first ms can be
+// short, since the clock doesn't restart when a delay begins.
+// Interrupts are on while it sleeps, and restored to how they were before
+// when it returns.
+void ms_clock_wait(uint16_t until);
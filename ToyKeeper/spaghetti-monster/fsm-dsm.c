@@ -0,0 +1,84 @@
+// fsm-dsm.c: Delta-sigma PWM modulation for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "fsm-dsm.h"
+
+void dsm_set(uint8_t ch, uint16_t lvl) {
+    dsm_lvl[ch]  = lvl;
+    dsm_base[ch] = lvl >> DSM_BITS;
+    dsm_frac[ch] = lvl << (8 - DSM_BITS);
+    dsm_pwm[ch]  = dsm_base[ch];
+}
+
+static inline void dsm_load_pwm() {
+    DSM_CH1_PWM = dsm_pwm[0];
+    #if DSM_CHANNELS > 1
+    DSM_CH2_PWM = dsm_pwm[1];
+    #endif
+    #if DSM_CHANNELS > 2
+    DSM_CH3_PWM = dsm_pwm[2];
+    #endif
+    #if DSM_CHANNELS > 3
+    DSM_CH4_PWM = dsm_pwm[3];
+    #endif
+}
+
+void dsm_start() {
+    dsm_load_pwm();
+    DSM_INTCTRL |= DSM_OVF_bm;
+}
+
+void dsm_stop() {
+    DSM_INTCTRL &= ~DSM_OVF_bm;
+    for (uint8_t ch = 0; ch < DSM_CHANNELS; ch ++)
+        dsm_set(ch, 0);
+    dsm_load_pwm();
+}
+
+#ifdef USE_SET_LEVEL_GRADUALLY
+bool dsm_gradual_tick(uint8_t ch, uint16_t target) {
+    uint16_t lvl = dsm_lvl[ch];
+    uint8_t steps = lvl >> DSM_GRADUAL_SHIFT;
+    for (uint8_t i=0; i<=steps; i++)
+        GRADUAL_ADJUST_SIMPLE(target, lvl);
+    dsm_set(ch, lvl);
+    return (lvl == target);
+}
+#endif
+
+// calculate one channel's next PWM value:
+// add the low bits to the error, and carry into the PWM value
+// (the error is 8 bits, so the carry is just the add's overflow)
+#define DSM_NEXT(ch) {  \
+        uint16_t sum = dsm_err[ch] + dsm_frac[ch];  \
+        dsm_err[ch] = sum;  \
+        dsm_pwm[ch] = dsm_base[ch] + (sum >> 8);  \
+    }
+
+// delta-sigma modulation of PWM outputs
+// happens on each timer overflow
+ISR(DSM_vect) {
+    // set new hardware values first,
+    // for best timing (reduce effect of interrupt jitter)
+    dsm_load_pwm();
+
+    // calculate next values, now that timing matters less
+    DSM_NEXT(0);
+    #if DSM_CHANNELS > 1
+    DSM_NEXT(1);
+    #endif
+    #if DSM_CHANNELS > 2
+    DSM_NEXT(2);
+    #endif
+    #if DSM_CHANNELS > 3
+    DSM_NEXT(3);
+    #endif
+
+    #ifdef DSM_INTFLAGS
+    // clear the interrupt flag to indicate it was handled
+    DSM_INTFLAGS = DSM_OVF_bm;
+    #endif
+}
@@ -0,0 +1,92 @@
+// fsm-dsm.h: Delta-sigma PWM modulation for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/*
+ * Delta-sigma modulation (DSM) adds a few bits of resolution on top of
+ * an 8-bit PWM timer.  Each level is (PWM << DSM_BITS) + DSM.  On each
+ * timer overflow, the low DSM_BITS are added to an error accumulator,
+ * and each time it overflows, that PWM cycle gets one extra count.  So
+ * the average over 2^DSM_BITS cycles is exact, and with the default of
+ * 7 extra bits, an 8-bit timer gets 15-bit dimming resolution.
+ *
+ * To use it, a hwdef defines:
+ *   USE_DELTA_SIGMA
+ *   DSM_CHANNELS    how many PWM outputs to modulate (1 to 4)
+ *   DSM_CH1_PWM     each output's PWM register, like OCR0A
+ *   DSM_CH2_PWM     ... (and so on, up to DSM_CHANNELS)
+ *   DSM_vect        the PWM timer's overflow interrupt
+ *   DSM_INTCTRL     the register which enables it
+ *   DSM_OVF_bm      ... and the bit to set there
+ *   DSM_INTFLAGS    (attiny 1-series only) where to clear the flag
+ * and optionally:
+ *   DSM_BITS        extra bits of resolution, default 7
+ *
+ * Then its set_level functions call dsm_set() for each channel, and
+ * dsm_start() afterward.  set_level_zero() calls dsm_stop().  Levels go
+ * from 0 to DSM_TOP, and ramp tables should use the same range.
+ *
+ * ISR cost:
+ *   The interrupt runs once per PWM cycle, which is 510 CPU cycles for
+ *   8-bit phase-correct PWM at clk/1, or 256 for fast PWM.  It must
+ *   finish well within that, or it'll drop cycles and eat all the CPU
+ *   time.  Counting instructions, it takes about 45 cycles of
+ *   overhead (interrupt response, register saves, reti), plus about 4
+ *   cycles per channel to load the PWM registers and 14 more to
+ *   calculate the next values.  That's roughly 65 / 85 / 100 / 120
+ *   cycles for 1 / 2 / 3 / 4 channels, or up to ~25% of the CPU with 4
+ *   channels on phase-correct PWM.  (hwdefs which use this should
+ *   lower DELAY_FACTOR to match)  The PWM registers are loaded first,
+ *   so interrupt latency only shifts when new values take effect, not
+ *   how long they last.
+ */
+
+#ifndef DSM_BITS
+#define DSM_BITS 7
+#endif
+#if (DSM_BITS < 1) || (DSM_BITS > 8)
+#error DSM_BITS must be 1 to 8.
+#endif
+
+#if (DSM_CHANNELS < 1) || (DSM_CHANNELS > 4)
+#error DSM_CHANNELS must be 1 to 4.
+#endif
+
+// highest level
+// (8 bits of PWM plus DSM_BITS of DSM, but the PWM part stops at 255
+//  so there's room to carry into it)
+#ifndef DSM_TOP
+#define DSM_TOP (255 << DSM_BITS)
+#endif
+
+// how fast gradual adjustments go
+// (higher = slower/finer, default is ((255 << 7) >> 9) = 63 steps max)
+#ifndef DSM_GRADUAL_SHIFT
+#define DSM_GRADUAL_SHIFT (DSM_BITS + 2)
+#endif
+
+// current level of each channel, 0 to DSM_TOP
+uint16_t dsm_lvl[DSM_CHANNELS];
+// ... split into the parts the ISR uses
+uint8_t dsm_base[DSM_CHANNELS];  // level >> DSM_BITS
+uint8_t dsm_frac[DSM_CHANNELS];  // low DSM_BITS, scaled up to 8 bits
+uint8_t dsm_err[DSM_CHANNELS];   // accumulated error
+uint8_t dsm_pwm[DSM_CHANNELS];   // PWM value for the next cycle
+
+// set one channel's level (takes effect at the next timer overflow)
+void dsm_set(uint8_t ch, uint16_t lvl);
+// put new levels into the PWM registers right away
+// (for a faster response, like for strobes), and start modulating
+void dsm_start();
+// turn off all channels and stop the interrupt
+// (helps improve button press handling from Off state)
+void dsm_stop();
+
+#ifdef USE_SET_LEVEL_GRADUALLY
+// move one channel a little closer to "target"
+// (faster/coarser when bright, slower/finer when dim)
+// returns true when it's there
+bool dsm_gradual_tick(uint8_t ch, uint16_t target);
+#endif
@@ -6,6 +6,17 @@
 
 #include "fsm-eeprom.h"
 
+#if defined(USE_EEPROM) || defined(USE_EEPROM_WL)
+// checksum of a record's sequence or lap number and data
+uint8_t eep_checksum(uint8_t * rec, uint8_t len) {
+    uint8_t sum = EEP_MARKER;
+    for (uint8_t i = 0; i < len; i ++) {
+        sum = ((sum << 1) | (sum >> 7)) ^ eeprom_read_byte(rec+i);
+    }
+    return sum;
+}
+#endif
+
 #ifdef USE_EEPROM
 #ifdef EEPROM_OVERRIDE
 uint8_t *eeprom;
@@ -13,6 +24,65 @@ uint8_t *eeprom;
 uint8_t eeprom[EEPROM_BYTES];
 #endif
 
+// (a sizeof() can't be checked with #if)
+#ifdef USE_EEPROM_WL
+_Static_assert(EEP_START + (2 * EEP_RECORD_SIZE) <= EEPSIZE,
+               "Requested EEPROM_BYTES too big.");
+#else
+_Static_assert(EEP_START + EEP_RECORD_SIZE <= EEPSIZE,
+               "Requested EEPROM_BYTES too big.");
+#endif
+
+uint8_t * eep_save_rec;  // which copy the next save overwrites
+uint8_t eep_save_seq;    // ... and its new sequence number
+
+// was this copy completely written?
+uint8_t eep_valid(uint8_t * rec) {
+    return (eeprom_read_byte(rec) != 0xFF)
+        && (eeprom_read_byte(rec+EEPROM_BYTES+1)
+            == eep_checksum(rec, EEPROM_BYTES+1));
+}
+
+// find the newest complete copy, or NULL if there isn't one
+uint8_t * eep_newest() {
+    uint8_t * a = EEP_COPY_A;
+    uint8_t * b = EEP_COPY_B;
+    if (! eep_valid(b)) b = NULL;
+    if (! eep_valid(a)) return b;
+    if (! b) return a;
+    // both are good, so the newer one has the next sequence number
+    if ((int8_t)(eeprom_read_byte(b) - eeprom_read_byte(a)) > 0) return b;
+    return a;
+}
+
+uint8_t * find_eeprom() {
+    uint8_t * rec = eep_newest();
+    if (rec) return rec + 1;
+    // older versions kept one copy, after an EEP_MARKER byte...
+    // which is where copy A's data is, so it doesn't get overwritten
+    // until copy B has a complete save in it
+    rec = EEP_COPY_A;
+    if (eeprom_read_byte(rec) == EEP_MARKER) return rec + 1;
+    return NULL;
+}
+
+// pick where the next save goes: over the older copy, or copy B if
+// there's no complete one yet
+void eep_save_begin() {
+    uint8_t * newest = eep_newest();
+    uint8_t * rec = EEP_COPY_B;
+    uint8_t seq = 0;
+    if (newest) {
+        if (newest == EEP_COPY_B) rec = EEP_COPY_A;
+        seq = eeprom_read_byte(newest) + 1;
+        // (older versions look for EEP_MARKER in copy A's first byte)
+        if (seq == EEP_MARKER) seq ++;
+        if (seq == 0xFF) seq = 0;  // 0xFF means blank
+    }
+    eep_save_rec = rec;
+    eep_save_seq = seq;
+}
+
 uint8_t load_eeprom() {
     #if defined(LED_ENABLE_PIN) || defined(LED2_ENABLE_PIN)
     delay_4ms(2);  // wait for power to stabilize
@@ -20,38 +90,70 @@ uint8_t load_eeprom() {
 
     cli();
     // check if eeprom has been initialized; abort if it hasn't
-    uint8_t marker = eeprom_read_byte((uint8_t *)EEP_START);
-    if (marker != EEP_MARKER) { sei(); return 0; }
+    uint8_t * data = find_eeprom();
+    if (! data) { sei(); return 0; }
 
     // load the actual data
     for(uint8_t i=0; i<EEPROM_BYTES; i++) {
-        eeprom[i] = eeprom_read_byte((uint8_t *)(EEP_START+1+i));
+        eeprom[i] = eeprom_read_byte(data+i);
     }
     sei();
     return 1;
 }
 
+#ifdef USE_EEPROM_ASYNC
+uint8_t eep_commit_pos;
+
+void save_eeprom() {
+    eeprom_commit_start(EEP_COMMIT_CFG);
+}
+#else
 void save_eeprom() {
     #if defined(LED_ENABLE_PIN) || defined(LED2_ENABLE_PIN)
     delay_4ms(2);  // wait for power to stabilize
     #endif
 
     cli();
+    eep_save_begin();
+    uint8_t * rec = eep_save_rec;
 
     // save the actual data
     for(uint8_t i=0; i<EEPROM_BYTES; i++) {
-        eeprom_update_byte((uint8_t *)(EEP_START+1+i), eeprom[i]);
+        eeprom_update_byte(rec+1+i, eeprom[i]);
     }
 
-    // save the marker last, to indicate the transaction is complete
-    eeprom_update_byte((uint8_t *)EEP_START, EEP_MARKER);
+    // then the sequence number, and the checksum last,
+    // to indicate the transaction is complete
+    eeprom_update_byte(rec, eep_save_seq);
+    eeprom_update_byte(rec+EEPROM_BYTES+1, eep_checksum(rec, EEPROM_BYTES+1));
     sei();
 }
+#endif  // ifdef USE_EEPROM_ASYNC
 #endif
 
 #ifdef USE_EEPROM_WL
 uint8_t eeprom_wl[EEPROM_WL_BYTES];
-uint8_t * eep_wl_prev_offset;
+uint8_t eep_wl_slot;  // where the next record goes
+uint8_t eep_wl_lap;   // ... and its lap number
+
+// was this record completely written?
+uint8_t eep_wl_valid(uint8_t slot) {
+    uint8_t * rec = EEP_WL_RECORD(slot);
+    return (eeprom_read_byte(rec) != 0xFF)
+        && (eeprom_read_byte(rec+EEPROM_WL_BYTES+1)
+            == eep_checksum(rec, EEPROM_WL_BYTES+1));
+}
+
+// move to the next slot, and start a new lap after the last one
+void eep_wl_advance() {
+    uint8_t slot = eep_wl_slot + 1;
+    if (slot >= EEP_WL_SLOTS) {
+        slot = 0;
+        eep_wl_lap ++;
+        if (eep_wl_lap == 0xFF) eep_wl_lap = 0;  // 0xFF means blank
+    }
+    eep_wl_slot = slot;
+}
 
 uint8_t load_eeprom_wl() {
     #if defined(LED_ENABLE_PIN) || defined(LED2_ENABLE_PIN)
@@ -59,54 +161,215 @@ uint8_t load_eeprom_wl() {
     #endif
 
     cli();
-    // check if eeprom has been initialized; abort if it hasn't
+    // records are written in order, so slot 0 through the newest record
+    // all have the same lap number, and later slots have an older one...
+    // so a binary search can find the newest record
+    uint8_t lap = eeprom_read_byte(EEP_WL_RECORD(0));
+    uint8_t lo = 0;
+    uint8_t hi = EEP_WL_SLOTS - 1;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi + 1) >> 1;
+        if (eeprom_read_byte(EEP_WL_RECORD(mid)) == lap) lo = mid;
+        else hi = mid - 1;
+    }
+
+    // if power was lost while writing the newest record,
+    // the one before it is still good
     uint8_t found = 0;
-    uint8_t * offset;
-    for(offset = 0;
-        offset < (uint8_t *)(EEP_WL_SIZE - EEPROM_WL_BYTES - 1);
-        offset += (EEPROM_WL_BYTES + 1)) {
-        if (eeprom_read_byte(offset) == EEP_MARKER) {
-            found = 1;
-            eep_wl_prev_offset = offset;
-            break;
-        }
+    uint8_t slot = lo;
+    for (uint8_t tries = 0; tries < 2; tries ++) {
+        if (eep_wl_valid(slot)) { found = 1; break; }
+        slot = (slot ? slot : EEP_WL_SLOTS) - 1;
     }
 
     if (found) {
         // load the actual data
+        uint8_t * rec = EEP_WL_RECORD(slot);
         for(uint8_t i=0; i<EEPROM_WL_BYTES; i++) {
-            eeprom_wl[i] = eeprom_read_byte(offset+1+i);
+            eeprom_wl[i] = eeprom_read_byte(rec+1+i);
         }
+        // and append after it next time
+        eep_wl_lap = eeprom_read_byte(rec);
+        eep_wl_slot = slot;
+        eep_wl_advance();
+    }
+    else {
+        // no log yet...  but older versions kept one copy of the data,
+        // after an EEP_MARKER byte, somewhere in the WL area
+        // (and erased everything else), so bring that over if it's there
+        uint8_t * offset;
+        for(offset = 0;
+            offset < (uint8_t *)(EEP_WL_SIZE - EEPROM_WL_BYTES - 1);
+            offset += (EEPROM_WL_BYTES + 1)) {
+            if (eeprom_read_byte(offset) == EEP_MARKER) {
+                for(uint8_t i=0; i<EEPROM_WL_BYTES; i++) {
+                    eeprom_wl[i] = eeprom_read_byte(offset+1+i);
+                }
+                found = 1;
+                break;
+            }
+        }
+
+        // start a new log, with a lap number which isn't in any slot yet
+        // (so leftover data can't confuse the search later)
+        lap = 0;
+        for (slot = 0; slot < EEP_WL_SLOTS; ) {
+            if (eeprom_read_byte(EEP_WL_RECORD(slot)) == lap) { lap ++; slot = 0; }
+            else slot ++;
+        }
+        eep_wl_lap = lap;
+        eep_wl_slot = 0;
     }
     sei();
     return found;
 }
 
+#ifdef USE_EEPROM_ASYNC
+uint8_t eep_wl_pos;
+
+void save_eeprom_wl() {
+    eeprom_commit_start(EEP_COMMIT_WL);
+}
+#else
 void save_eeprom_wl() {
     #if defined(LED_ENABLE_PIN) || defined(LED2_ENABLE_PIN)
     delay_4ms(2);  // wait for power to stabilize
     #endif
 
     cli();
-    // erase old state
-    uint8_t * offset = eep_wl_prev_offset;
-    for (uint8_t i = 0; i < EEPROM_WL_BYTES+1; i ++) {
-        eeprom_update_byte(offset+i, 0xFF);
+    // append a new record, without erasing the old one
+    // (user data, then lap number, then checksum last, so a record is
+    //  only valid after it's completely written)
+    uint8_t * rec = EEP_WL_RECORD(eep_wl_slot);
+    for(uint8_t i=0; i<EEPROM_WL_BYTES; i++) {
+        eeprom_update_byte(rec+1+i, eeprom_wl[i]);
     }
+    eeprom_update_byte(rec, eep_wl_lap);
+    eeprom_update_byte(rec+EEPROM_WL_BYTES+1,
+                       eep_checksum(rec, EEPROM_WL_BYTES+1));
+    eep_wl_advance();
+    sei();
+}
+#endif  // ifdef USE_EEPROM_ASYNC
+#endif
 
-    // save new state
-    offset += EEPROM_WL_BYTES+1;
-    if (offset > (uint8_t *)(EEP_WL_SIZE-EEPROM_WL_BYTES-1)) offset = 0;
-    eep_wl_prev_offset = offset;
-    // marker byte
-    // FIXME: write the marker last, to signal completed transaction
-    eeprom_update_byte(offset, EEP_MARKER);
-    offset ++;
-    // user data
-    for(uint8_t i=0; i<EEPROM_WL_BYTES; i++, offset++) {
-        eeprom_update_byte(offset, eeprom_wl[i]);
+#ifdef USE_EEPROM_ASYNC
+inline void EEPROM_ready_int_on() {
+    #ifdef AVRXMEGA3  // ATTINY816, 817, etc
+    NVMCTRL.INTCTRL = NVMCTRL_EEREADY_bm;
+    #else
+    EECR |= (1 << EERIE);
+    #endif
+}
+
+inline void EEPROM_ready_int_off() {
+    #ifdef AVRXMEGA3  // ATTINY816, 817, etc
+    NVMCTRL.INTCTRL = 0;
+    #else
+    EECR &= ~(1 << EERIE);
+    #endif
+}
+
+void eeprom_commit_start(uint8_t which) {
+    #if defined(LED_ENABLE_PIN) || defined(LED2_ENABLE_PIN)
+    delay_4ms(2);  // wait for power to stabilize
+    #endif
+    // (the interrupt uses these too, so it has to wait)
+    cli();
+    uint8_t pending = eeprom_commit_pending;
+    #ifdef USE_EEPROM
+    // start over, in case some data changed after it was written
+    // (if a save was cut short, its copy is still the older one)
+    if (which & EEP_COMMIT_CFG) {
+        eep_save_begin();
+        eep_commit_pos = 0;
     }
+    #endif
+    #ifdef USE_EEPROM_WL
+    // if a save is already running, it'll notice the new data when done
+    if ((which & EEP_COMMIT_WL) && !(pending & EEP_COMMIT_WL))
+        eep_wl_pos = 0;
+    #endif
+    eeprom_commit_pending = pending | which;
+    EEPROM_ready_int_on();
     sei();
 }
+
+void eeprom_commit_wait() {
+    while (eeprom_commit_pending) {}
+}
+
+// do the next step of whichever save is in progress:
+// skip one unchanged byte, or write one changed byte
+// returns 0 when there's nothing left to do
+uint8_t eeprom_commit_step() {
+    uint8_t pending = eeprom_commit_pending;
+
+    #ifdef USE_EEPROM
+    if (pending & EEP_COMMIT_CFG) {
+        uint8_t * rec = eep_save_rec;
+        uint8_t i = eep_commit_pos;
+        eep_commit_pos = i + 1;
+        // user data first
+        if (i < EEPROM_BYTES) {
+            eeprom_update_byte(rec+1+i, eeprom[i]);
+        }
+        // then the sequence number
+        else if (i == EEPROM_BYTES) {
+            eeprom_update_byte(rec, eep_save_seq);
+        }
+        // then the checksum, which makes this copy the newest one
+        else {
+            eeprom_update_byte(rec+EEPROM_BYTES+1,
+                               eep_checksum(rec, EEPROM_BYTES+1));
+            eeprom_commit_pending = pending & (~EEP_COMMIT_CFG);
+        }
+        return 1;
+    }
+    #endif
+
+    #ifdef USE_EEPROM_WL
+    if (pending & EEP_COMMIT_WL) {
+        uint8_t * rec = EEP_WL_RECORD(eep_wl_slot);
+        uint8_t i = eep_wl_pos;
+        eep_wl_pos = i + 1;
+        // user data first
+        if (i < EEPROM_WL_BYTES) {
+            eeprom_update_byte(rec+1+i, eeprom_wl[i]);
+        }
+        // then the lap number
+        else if (i == EEPROM_WL_BYTES) {
+            eeprom_update_byte(rec, eep_wl_lap);
+        }
+        // then the checksum, which makes the record valid
+        // (calculated from what was written, in case the data changed)
+        else {
+            eeprom_update_byte(rec+EEPROM_WL_BYTES+1,
+                               eep_checksum(rec, EEPROM_WL_BYTES+1));
+            eep_wl_advance();
+            // if the data changed during the save, save it again
+            uint8_t changed = 0;
+            for (i = 0; i < EEPROM_WL_BYTES; i ++) {
+                if (eeprom_read_byte(rec+1+i) != eeprom_wl[i]) changed = 1;
+            }
+            if (changed) eep_wl_pos = 0;
+            else eeprom_commit_pending = pending & (~EEP_COMMIT_WL);
+        }
+        return 1;
+    }
+    #endif
+
+    return 0;
+}
+
+#ifdef AVRXMEGA3  // ATTINY816, 817, etc
+ISR(NVMCTRL_EE_vect) {
+#else
+ISR(EE_RDY_vect) {
 #endif
+    // this interrupt repeats for as long as the EEPROM is ready,
+    // so each call only needs to handle one byte
+    if (! eeprom_commit_step()) EEPROM_ready_int_off();
+}
+#endif  // ifdef USE_EEPROM_ASYNC
 
@@ -28,7 +28,22 @@ uint8_t eeprom[EEPROM_BYTES];
 #endif
 uint8_t load_eeprom();  // returns 1 for success, 0 for no data found
 void save_eeprom();
+// where the saved data starts, or NULL if nothing was saved
+// (for checking what kind of data it is before loading it)
+uint8_t * find_eeprom();
 #define EEP_START (EEPSIZE/2)
+// the data is kept in two copies, and each save overwrites the older one,
+// so the newest one is still there if power is lost partway through:
+// sequence number, user data, checksum
+#define EEP_RECORD_SIZE (EEPROM_BYTES+2)
+#define EEP_COPY_A ((uint8_t *)EEP_START)
+#ifdef USE_EEPROM_WL
+// (the WL log uses the whole first half, so both go in the second)
+#define EEP_COPY_B ((uint8_t *)(EEP_START + EEP_RECORD_SIZE))
+#else
+// (nothing else uses the first half, so put it right before the first)
+#define EEP_COPY_B ((uint8_t *)(EEP_START - EEP_RECORD_SIZE))
+#endif
 #endif
 
 #ifdef USE_EEPROM_WL
@@ -39,6 +54,11 @@ uint8_t eeprom_wl[EEPROM_WL_BYTES];
 uint8_t load_eeprom_wl();  // returns 1 for success, 0 for no data found
 void save_eeprom_wl();
 #define EEP_WL_SIZE (EEPSIZE/2)
+// the WL area is a log of records, oldest ones overwritten first:
+// lap number, user data, checksum
+#define EEP_WL_RECORD_SIZE (EEPROM_WL_BYTES+2)
+#define EEP_WL_SLOTS (EEP_WL_SIZE / EEP_WL_RECORD_SIZE)
+#define EEP_WL_RECORD(slot) ((uint8_t *)((slot) * EEP_WL_RECORD_SIZE))
 #endif
 
 #if EEPSIZE > 256
@@ -47,6 +67,21 @@ void save_eeprom_wl();
 #define EEP_OFFSET_T uint8_t
 #endif
 
-// if this marker isn't found, the eeprom is assumed to be blank
+// older versions saved this right before the data, to show it was there
+// (the checksums start with it too)
 #define EEP_MARKER 0b10100101
 
+#ifdef USE_EEPROM_ASYNC
+// save in the background, one byte per EEPROM-ready interrupt,
+// instead of disabling interrupts for the whole save
+// (each changed byte takes ~3.4 ms, which adds up quickly)
+// which saves are still in progress:
+#define EEP_COMMIT_CFG 1  // save_eeprom()
+#define EEP_COMMIT_WL  2  // save_eeprom_wl()
+volatile uint8_t eeprom_commit_pending = 0;
+void eeprom_commit_start(uint8_t which);
+// wait for all saves to finish
+// (before anything which would stop the EEPROM-ready interrupt)
+void eeprom_commit_wait();
+#endif
+
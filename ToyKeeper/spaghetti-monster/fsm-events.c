@@ -8,47 +8,109 @@
 
 
 void append_emission(Event event, uint16_t arg) {
-    uint8_t i;
-    // find last entry
-    for(i=0;
-        (i<EMISSION_QUEUE_LEN) && (emissions[i].event != EV_none);
-        i++) { }
-    // add new entry
-    if (i < EMISSION_QUEUE_LEN) {
-        emissions[i].event = event;
-        emissions[i].arg = arg;
-    } else {
-        // TODO: if queue full, what should we do?
+    #ifdef USE_EVENT_COALESCING
+    // ticks only carry a timer, so if an older one of the same type is
+    // still waiting, update its timer instead of adding another
+    // (this keeps the queue short when the main loop is busy for a while)
+    // (hold events aren't merged, since UIs count their frames)
+    if ((event == EV_tick)
+        #ifdef TICK_DURING_STANDBY
+        || (event == EV_sleep_tick)
+        #endif
+        ) {
+        for (uint8_t i = emissions_tail; i != emissions_head; ) {
+            i --;
+            Emission *e = emissions + (i & EMISSION_QUEUE_MASK);
+            if (e->event == event) {
+                e->arg = arg;
+                return;
+            }
+            // never merge across a different button event,
+            // so button edges stay in order
+            if (e->event & B_CLICK) break;
+        }
     }
+    #endif
+
+    // if queue is full, drop the oldest entry to make room
+    // (newer button events include the whole click count so far,
+    //  so they're more useful than the old ones)
+    if ((uint8_t)(emissions_tail - emissions_head) >= EMISSION_QUEUE_LEN)
+        emissions_head ++;
+    // add new entry
+    Emission *e = emissions + (emissions_tail & EMISSION_QUEUE_MASK);
+    e->event = event;
+    e->arg = arg;
+    emissions_tail ++;
 }
 
 void delete_first_emission() {
-    uint8_t i;
-    for(i=0; i<EMISSION_QUEUE_LEN-1; i++) {
-        emissions[i].event = emissions[i+1].event;
-        emissions[i].arg = emissions[i+1].arg;
-    }
-    emissions[i].event = EV_none;
-    emissions[i].arg = 0;
+    if (emissions_head != emissions_tail)
+        emissions_head ++;
 }
 
 void process_emissions() {
-    while (emissions[0].event != EV_none) {
-        emit_now(emissions[0].event, emissions[0].arg);
+    while (emissions_head != emissions_tail) {
+        Emission *e = emissions + (emissions_head & EMISSION_QUEUE_MASK);
+        Event event = e->event;
+        uint16_t arg = e->arg;
+        // remove it before handling, in case the handler runs a
+        // nice_delay_ms() which processes the rest of the queue
         delete_first_emission();
+        emit_now(event, arg);
     }
 }
 
+#ifdef USE_EVENT_DISPATCH_TABLE
+uint8_t event_kind(Event event) {
+    if (event & B_CLICK) {
+        if (event & B_TIMEOUT) return EVK_TIMEOUT;
+        if (event & B_PRESS) return EVK_PRESS;
+        return EVK_RELEASE;
+    }
+    if (event == EV_tick) return EVK_TICK;
+    #ifdef TICK_DURING_STANDBY
+    if (event == EV_sleep_tick) return EVK_SLEEP;
+    #endif
+    #ifdef USE_LVP
+    if (event == EV_voltage_low) return EVK_LVP;
+    #endif
+    #ifdef USE_THERMAL_REGULATION
+    if ((event >= EV_temperature_high) && (event <= EV_temperature_okay))
+        return EVK_THERMAL;
+    #endif
+    return EVK_OTHER;
+}
+#endif
+
 // Call stacked callbacks for the given event until one handles it.
 uint8_t emit_now(Event event, uint16_t arg) {
+    #ifdef USE_LATENCY_PROBE
+    if (event & B_CLICK) latency_probe(LP_EMIT_NOW);
+    #endif
+
+    #ifdef USE_EVENT_DISPATCH_TABLE
+    uint8_t kind = event_kind(event);
     for(int8_t i=state_stack_len-1; i>=0; i--) {
+        // skip states which never handle this kind of event
+        if (! (state_stack_kinds[i] & kind)) continue;
         uint8_t err = state_stack[i](event, arg);
         if (! err) return 0;
     }
+    #else
+    for(int8_t i=state_stack_len-1; i>=0; i--) {
+        uint8_t err = state_stack[i](event, arg);
+        if (! err) return 0;
+    }
+    #endif
     return 1;  // event not handled
 }
 
 void emit(Event event, uint16_t arg) {
+    #ifdef USE_LATENCY_PROBE
+    if (event & B_CLICK) latency_probe(LP_EMIT);
+    #endif
+
     // add this event to the queue for later,
     // so we won't use too much time during an interrupt
     append_emission(event, arg);
@@ -105,6 +167,40 @@ uint8_t push_event(uint8_t ev_type) {  // only for use by PCINT_inner()
 volatile uint8_t nice_delay_interrupt = 0;
 inline void interrupt_nice_delays() { nice_delay_interrupt = 1; }
 
+// wait 1 ms, underclocked if the light is dim enough
+// (one step of nice_delay_ms(), without handling any events)
+void nice_delay_1ms() {
+    #ifdef USE_DYNAMIC_UNDERCLOCKING
+    #ifdef USE_RAMPING
+    uint8_t level = actual_level;  // volatile, avoid repeat access
+    if (level < QUARTERSPEED_LEVEL) {
+        clock_prescale_set(clock_div_4);
+        _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100/4);
+    }
+    //else if (level < HALFSPEED_LEVEL) {
+    //    clock_prescale_set(clock_div_2);
+    //    _delay_loop_2(BOGOMIPS*95/100/2);
+    //}
+    else {
+        clock_prescale_set(clock_div_1);
+        _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100);
+    }
+    // restore regular clock speed
+    clock_prescale_set(clock_div_1);
+    #else
+    // underclock MCU to save power
+    clock_prescale_set(clock_div_4);
+    // wait
+    _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100/4);
+    // restore regular clock speed
+    clock_prescale_set(clock_div_1);
+    #endif  // ifdef USE_RAMPING
+    #else
+    // wait
+    _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100);
+    #endif  // ifdef USE_DYNAMIC_UNDERCLOCKING
+}
+
 // like delay_ms, except it aborts on state change
 // return value:
 //   0: state changed
@@ -117,40 +213,28 @@ uint8_t nice_delay_ms(uint16_t ms) {
         return 1;
     }
     */
+    #ifdef USE_IDLE_MODE
+    loop_busy = 1;  // don't doze between animation frames
+    #endif
+    #ifdef MS_CLOCK_vect
+    #ifdef USE_DYNAMIC_UNDERCLOCKING
+    // stay at full speed, so each clock tick is 1 ms
+    clock_prescale_set(clock_div_1);
+    #endif
+    uint16_t until = ms_clock_now();
+    #endif
     while(ms-- > 0) {
         if (nice_delay_interrupt) {
             return 0;
         }
 
-        #ifdef USE_DYNAMIC_UNDERCLOCKING
-        #ifdef USE_RAMPING
-        uint8_t level = actual_level;  // volatile, avoid repeat access
-        if (level < QUARTERSPEED_LEVEL) {
-            clock_prescale_set(clock_div_4);
-            _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100/4);
-        }
-        //else if (level < HALFSPEED_LEVEL) {
-        //    clock_prescale_set(clock_div_2);
-        //    _delay_loop_2(BOGOMIPS*95/100/2);
-        //}
-        else {
-            clock_prescale_set(clock_div_1);
-            _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100);
-        }
-        // restore regular clock speed
-        clock_prescale_set(clock_div_1);
-        #else
-        // underclock MCU to save power
-        clock_prescale_set(clock_div_4);
-        // wait
-        _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100/4);
-        // restore regular clock speed
-        clock_prescale_set(clock_div_1);
-        #endif  // ifdef USE_RAMPING
+        #ifdef MS_CLOCK_vect
+        // sleep instead of spinning, and catch up if the last step
+        // spent a while handling events
+        ms_clock_wait(++until);
         #else
-        // wait
-        _delay_loop_2(BOGOMIPS*DELAY_FACTOR/100);
-        #endif  // ifdef USE_DYNAMIC_UNDERCLOCKING
+        nice_delay_1ms();
+        #endif
 
         // run pending system processes while we wait
         handle_deferred_interrupts();
@@ -165,7 +249,18 @@ uint8_t nice_delay_ms(uint16_t ms) {
     return 1;
 }
 
-#ifdef USE_DYNAMIC_UNDERCLOCKING
+#ifdef MS_CLOCK_vect
+void delay_4ms(uint8_t ms) {
+    #ifdef USE_DYNAMIC_UNDERCLOCKING
+    clock_prescale_set(clock_div_1);
+    #endif
+    uint16_t until = ms_clock_now();
+    while(ms-- > 0) {
+        until += 4;
+        ms_clock_wait(until);
+    }
+}
+#elif defined(USE_DYNAMIC_UNDERCLOCKING)
 void delay_4ms(uint8_t ms) {
     while(ms-- > 0) {
         // underclock MCU to save power
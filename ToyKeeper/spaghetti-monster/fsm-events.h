@@ -36,11 +36,25 @@ static volatile uint16_t ticks_since_last_event = 0;
 
 // maximum number of events which can be waiting at one time
 // (would probably be okay to reduce this to 4, but it's higher to be safe)
+// (must be a power of two, so the ring buffer can wrap with a bit mask)
+#ifndef EMISSION_QUEUE_LEN
 #define EMISSION_QUEUE_LEN 16
+#endif
+#if (EMISSION_QUEUE_LEN & (EMISSION_QUEUE_LEN - 1)) || (EMISSION_QUEUE_LEN > 128)
+#error "EMISSION_QUEUE_LEN must be a power of two, 128 or less"
+#endif
+#define EMISSION_QUEUE_MASK (EMISSION_QUEUE_LEN - 1)
 // was "volatile" before, changed to regular var since IRQ rewrites seem
 // to have removed the need for it to be volatile
 // no comment about "volatile emissions"
+// ring buffer: head is the oldest entry, tail is where the next one goes
+// (both count up forever and wrap at 256, so tail-head is the queue length)
 Emission emissions[EMISSION_QUEUE_LEN];
+uint8_t emissions_head = 0;
+uint8_t emissions_tail = 0;
+// with USE_EVENT_COALESCING, a new EV_tick / EV_sleep_tick replaces the
+// arg of a matching one which hasn't been handled yet, instead of taking
+// another slot in the queue
 
 void append_emission(Event event, uint16_t arg);
 void delete_first_emission();
@@ -51,6 +65,22 @@ void emit_current_event(uint16_t arg);
 void empty_event_sequence();
 uint8_t push_event(uint8_t ev_type);  // only for use by PCINT_inner()
 
+#ifdef USE_EVENT_DISPATCH_TABLE
+// broad kinds of events, so emit_now() can skip states which don't
+// handle a whole kind of event (see state_events[] in fsm-states.h)
+#define EVK_TICK     0b00000001  // EV_tick
+#define EVK_SLEEP    0b00000010  // EV_sleep_tick
+#define EVK_PRESS    0b00000100  // button down: press or hold
+#define EVK_RELEASE  0b00001000  // button up
+#define EVK_TIMEOUT  0b00010000  // click sequence done: complete or hold_release
+#define EVK_LVP      0b00100000  // EV_voltage_low
+#define EVK_THERMAL  0b01000000  // EV_temperature_*
+#define EVK_OTHER    0b10000000  // anything else
+#define EVK_BUTTON   (EVK_PRESS | EVK_RELEASE | EVK_TIMEOUT)
+#define EVK_ALL      0b11111111
+uint8_t event_kind(Event event);
+#endif
+
 
 // TODO: Maybe move these to their own file...
 // ... this probably isn't the right place for delays.
@@ -60,6 +90,7 @@ uint8_t push_event(uint8_t ev_type);  // only for use by PCINT_inner()
     #define DELAY_FACTOR 92
 #endif
 inline void interrupt_nice_delays();
+void nice_delay_1ms();
 uint8_t nice_delay_ms(uint16_t ms);
 //uint8_t nice_delay_s();
 void delay_4ms(uint8_t ms);
@@ -95,6 +126,9 @@ void delay_4ms(uint8_t ms);
 #define EV_leave_state         (B_SYSTEM|0b00001001)
 #define EV_reenter_state       (B_SYSTEM|0b00001010)
 #define EV_tick                (B_SYSTEM|0b00000001)
+#ifdef USE_TIMERS
+#define EV_timer               (B_SYSTEM|0b00000010)
+#endif
 #ifdef TICK_DURING_STANDBY
 #define EV_sleep_tick          (B_SYSTEM|0b00000011)
 #endif
@@ -0,0 +1,79 @@
+// fsm-latency.c: Button-to-light latency probe for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <util/atomic.h>
+
+#include "fsm-latency.h"
+
+inline void latency_probe_init() {
+    #if defined(AVRXMEGA3) && !defined(FSM_SIM)
+    // start the RTC counter (PIT runs either way, counter doesn't)
+    while (RTC.STATUS > 0) {}  // make sure the register is ready
+    RTC.CTRLA = RTC_RTCEN_bm | RTC_RUNSTDBY_bm;
+    #endif
+}
+
+// record a timestamp, if this stage is next in the current capture
+void latency_probe(uint8_t stage) {
+    // (called from interrupts and from the main loop, so an interrupt
+    //  mustn't change the capture halfway through)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        uint8_t done = latency_stages;
+        uint8_t bit = 1 << stage;
+
+        // a new button change starts over, if the last one was already seen
+        if ((stage <= LP_WDT) && (done & (1 << LP_WDT))) done = 0;
+        // only the first time through each stage counts
+        if (done & bit) return;
+        // later stages only count after the stage before them
+        if ((stage > LP_WDT) && (! (done & (bit >> 1)))) return;
+
+        #ifdef LATENCY_PROBE_TOGGLE
+        LATENCY_PROBE_TOGGLE();
+        #endif
+
+        #ifdef FSM_SIM
+        sim_latency_probe(stage);
+        #endif
+
+        if (! latency_frozen) {
+            if (! done) latency_log_len = 0;
+            LatencySample *s = latency_log + latency_log_len;
+            s->stage = stage;
+            s->time = LATENCY_CLOCK();
+            latency_log_len ++;
+        }
+
+        done |= bit;
+        if (stage == LP_SET_LEVEL) {
+            // capture complete; keep it until the UI reads it
+            if (latency_log_len) latency_frozen = 1;
+            done = 0;
+        }
+        latency_stages = done;
+    }
+}
+
+// blink each stage's time since the first one, in ms, then start over
+// (missing stages blink as zero)
+uint8_t latency_blink() {
+    uint8_t len = latency_log_len;
+    uint16_t start = latency_log[0].time;
+    uint8_t i = 1;
+    for (uint8_t stage = latency_log[0].stage + 1; stage < LP_STAGES; stage++) {
+        uint16_t ms = 0;
+        if ((i < len) && (latency_log[i].stage == stage)) {
+            uint16_t elapsed = latency_log[i].time - start;
+            ms = (uint32_t)elapsed * 1000 / LATENCY_CLOCK_HZ;
+            i ++;
+        }
+        if (ms > 255) ms = 255;
+        if (! blink_num(ms)) break;
+    }
+    latency_log_len = 0;
+    latency_frozen = 0;
+    return 1;
+}
@@ -0,0 +1,70 @@
+// fsm-latency.h: Button-to-light latency probe for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/*
+ * With USE_LATENCY_PROBE, each stage of the input pipeline records a
+ * timestamp when a button change passes through it, from the pin change
+ * interrupt to the first set_level() afterward.  This measures how long
+ * it takes a click to change the light, and where that time goes.
+ *
+ * Only one capture is kept.  After it completes (reaches set_level()),
+ * recording stops until latency_blink() reads it out, so the UI can blink
+ * the numbers later without measuring its own blinks.
+ *
+ * In the simulator, each stage is also printed as it happens.
+ * For a scope or logic analyzer, define LATENCY_PROBE_TOGGLE() to flip a
+ * spare pin at each stage, like:
+ *   #define LATENCY_PROBE_TOGGLE() (PINB = (1 << PB5))
+ */
+
+// pipeline stages, in order
+#define LP_ISR        0  // pin change interrupt
+#define LP_WDT        1  // WDT_inner() (or a PCINT edge) noticed the change
+#define LP_EMIT       2  // button event added to the queue
+#define LP_EMIT_NOW   3  // button event sent to the state stack
+#define LP_SET_LEVEL  4  // first set_level() afterward
+#define LP_STAGES     5
+
+// time source for timestamps
+#if defined(FSM_SIM)
+    uint16_t sim_latency_clock();  // 10us per count
+    void sim_latency_probe(uint8_t stage);
+    #define LATENCY_CLOCK() sim_latency_clock()
+    #define LATENCY_CLOCK_HZ 100000
+#elif defined(AVRXMEGA3)  // ATTINY816, 817, etc
+    // RTC counter, from the same 32 kHz clock as the PIT
+    #define LATENCY_CLOCK() RTC.CNT
+    #define LATENCY_CLOCK_HZ 32768
+#else
+    // no spare timer on these, so only count WDT ticks...  which means
+    // each time is only accurate to 16 ms (or more, with slow ticks)
+    // (use LATENCY_PROBE_TOGGLE() and a scope for finer detail)
+    volatile uint16_t latency_ticks = 0;
+    #define LATENCY_CLOCK() latency_ticks
+    #define LATENCY_CLOCK_HZ TICKS_PER_SECOND
+#endif
+
+typedef struct LatencySample {
+    uint8_t stage;
+    uint16_t time;
+} LatencySample;
+
+LatencySample latency_log[LP_STAGES];
+uint8_t latency_log_len = 0;
+// which stages the current capture has passed through (bit per stage)
+volatile uint8_t latency_stages = 0;
+// capture complete, waiting for latency_blink()
+uint8_t latency_frozen = 0;
+
+inline void latency_probe_init();
+void latency_probe(uint8_t stage);
+uint8_t latency_blink();
+
+// latency_blink() needs this
+// (so this header is included before fsm-misc.h)
+#ifndef USE_BLINK_NUM
+#define USE_BLINK_NUM
+#endif
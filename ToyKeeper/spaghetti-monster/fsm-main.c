@@ -109,6 +109,10 @@ int main() {
 
     hw_setup();
 
+    #ifdef USE_LATENCY_PROBE
+    latency_probe_init();
+    #endif
+
     #if 0
     #ifdef HALFSPEED
     // run at half speed
@@ -160,6 +164,9 @@ int main() {
         // enter standby mode if requested
         // (works better if deferred like this)
         if (go_to_standby) {
+            #ifdef USE_ANIMATION
+            anim_stop();
+            #endif
             #ifdef USE_RAMPING
             set_level(0);
             #else
@@ -186,8 +193,25 @@ int main() {
         nice_delay_interrupt = 0;
 
         // give the recipe some time slices
+        #ifdef USE_IDLE_MODE
+        loop_busy = 0;
+        #endif
         loop();
 
+        #ifdef USE_ANIMATION
+        // show the next animation frame, if it's time
+        anim_run();
+        #endif
+
+        #ifdef FSM_SIM
+        sim_main_loop();
+        #endif
+
+        #ifdef USE_IDLE_MODE
+        // doze until the next interrupt, if there's nothing else to do
+        if (! loop_busy) idle_mode();
+        #endif
+
     }
 }
 
@@ -199,10 +223,26 @@ void handle_deferred_interrupts() {
         // (PCINT only matters during standby)
     }
     */
+    #ifdef USE_ADAPTIVE_TICK
+    // (... and during slow ticks while awake)
+    if (irq_pcint) {  // button changed; go back to normal speed
+        irq_pcint = 0;
+        // (unless the slow tick just ended anyway)
+        if ((tick_scale > 1) && (! irq_wdt)) {
+            tick_cut_short = 1;
+            irq_wdt = 1;  // and check the button now, not a tick later
+        }
+    }
+    #endif
     if (irq_adc) {  // ADC done measuring
         adc_deferred();
         // irq_adc = 0;  // takes care of itself
     }
+    #ifdef USE_BUTTON_EDGE_TIMING
+    if (irq_button_edge) {  // button changed; don't wait for a tick
+        button_edge_inner();
+    }
+    #endif
     if (irq_wdt) {  // the clock ticked
         WDT_inner();
         // irq_wdt = 0;  // takes care of itself
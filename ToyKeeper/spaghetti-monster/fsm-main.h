@@ -8,3 +8,11 @@ int main();
 // needs to run frequently to execute the logic for WDT and ADC and stuff
 void handle_deferred_interrupts();
 
+#ifdef USE_IDLE_MODE
+// set this during loop() if there's more to do right away,
+// so the main loop won't doze until the next interrupt
+// (nice_delay_ms() sets it automatically, since a loop() which waits
+//  is usually in the middle of an animation)
+uint8_t loop_busy = 0;
+#endif
+
@@ -7,6 +7,12 @@
 #ifdef USE_DYNAMIC_UNDERCLOCKING
 void auto_clock_speed() {
     uint8_t level = actual_level;  // volatile, avoid repeat access
+    #if defined(USE_ANIMATION) && defined(MS_CLOCK_vect) && (! defined(AVRXMEGA3))
+    // the animation clock slows down with the MCU, and loses track of
+    // time when the speed changes in the middle of a tick, so stay at
+    // full speed while animating
+    if (anim_busy()) level = 255;
+    #endif
     if (level < QUARTERSPEED_LEVEL) {
         // run at quarter speed
         // note: this only works when executed as two consecutive instructions
@@ -290,6 +296,10 @@ uint8_t triangle_wave(uint8_t phase) {
 
 #ifdef USE_REBOOT
 void reboot() {
+    #ifdef USE_EEPROM_ASYNC
+    eeprom_commit_wait();  // finish saving first
+    #endif
+
     // put the WDT in hard reset mode, then trigger it
     cli();
     #if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85)
@@ -68,6 +68,35 @@ inline void PCINT_off() {
 
     irq_pcint = 1;  // let deferred code know an interrupt happened
 
+    #ifdef USE_BUTTON_EDGE_TIMING
+    // handle the first edge right away, then ignore the bounces after it
+    if (! button_debounce) {
+        uint8_t pressed = ((SWITCH_PORT & (1<<SWITCH_PIN)) == 0);
+        if (pressed != button_edge_state) {
+            button_edge_state = pressed;
+            // (if a tick already happened but hasn't been handled yet,
+            //  it came before this edge, so it shouldn't count)
+            button_debounce = BUTTON_DEBOUNCE_TICKS + irq_wdt;
+            #if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85)
+            if (WDTCR & (1<<WDIF)) button_debounce ++;
+            #elif (ATTINY == 1634)
+            if (WDTCSR & (1<<WDIF)) button_debounce ++;
+            #endif
+            irq_button_edge = 1;
+            #ifndef AVRXMEGA3
+            // restart the tick timer, so the next tick is exactly one
+            // tick after the edge (makes tick-based hold / release
+            // timing accurate, instead of off by up to a tick)
+            wdt_reset();
+            #endif
+        }
+    }
+    #endif
+
+    #ifdef USE_LATENCY_PROBE
+    latency_probe(LP_ISR);
+    #endif
+
     //DEBUG_FLASH;
 
     // as it turns out, it's more reliable to detect pin changes from WDT
@@ -81,6 +110,9 @@ inline void PCINT_off() {
 // (is a separate function to reduce code duplication)
 void PCINT_inner(uint8_t pressed) {
     button_last_state = pressed;
+    #ifdef USE_BUTTON_EDGE_TIMING
+    button_edge_state = pressed;
+    #endif
 
     // register the change, and send event to the current state callback
     if (pressed) {  // user pressed button
@@ -94,3 +126,18 @@ void PCINT_inner(uint8_t pressed) {
     ticks_since_last_event = 0;
 }
 
+#ifdef USE_BUTTON_EDGE_TIMING
+// button changed according to PCINT, so send events now
+// instead of waiting for WDT to notice
+void button_edge_inner() {
+    irq_button_edge = 0;
+    uint8_t pressed = button_edge_state;
+    if (pressed != button_last_state) {
+        #ifdef USE_LATENCY_PROBE
+        latency_probe(LP_WDT);
+        #endif
+        go_to_standby = 0;
+        PCINT_inner(pressed);
+    }
+}
+#endif
@@ -13,3 +13,20 @@ inline void PCINT_on();
 inline void PCINT_off();
 void PCINT_inner(uint8_t pressed);
 
+#ifdef USE_BUTTON_EDGE_TIMING
+// after a button change, ignore further changes for this many ticks
+// (because the switch is probably still bouncing)
+#ifndef BUTTON_DEBOUNCE_TICKS
+    #ifdef AVRXMEGA3  // ATTINY816, 817, etc
+    // PIT phase can't be reset, so the next tick might come right away
+    #define BUTTON_DEBOUNCE_TICKS 2
+    #else
+    #define BUTTON_DEBOUNCE_TICKS 1
+    #endif
+#endif
+volatile uint8_t irq_button_edge = 0;  // PCINT saw a real button change
+volatile uint8_t button_edge_state = 0;  // debounced state from PCINT
+volatile uint8_t button_debounce = 0;  // ticks until changes count again
+void button_edge_inner();
+#endif
+
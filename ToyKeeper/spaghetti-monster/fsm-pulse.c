@@ -0,0 +1,62 @@
+// fsm-pulse.c: Hardware-timed flashes for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <util/atomic.h>
+
+#include "fsm-pulse.h"
+
+void pulse_start(uint8_t level, uint16_t us) {
+    set_level(level);  // (also cancels the old pulse)
+
+    uint16_t cnt = (us + (PULSE_US_PER_CNT / 2)) / PULSE_US_PER_CNT;
+    // the first compare match is 2 to PULSE_CNT_TOP counts away,
+    // (any closer, and the counter could pass it before it's set)
+    // and each full trip around the timer adds PULSE_CNT_TOP more
+    uint8_t first = cnt % PULSE_CNT_TOP;
+    uint8_t wraps = cnt / PULSE_CNT_TOP;
+    if ((! first) && wraps) { first = PULSE_CNT_TOP; wraps --; }
+    if (first < 2) first = 2;
+
+    // don't let other interrupts make this late
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // the match happens when the counter moves past the compare value
+        uint16_t cmp = PULSE_CNT + first - 1;
+        if (cmp >= PULSE_CNT_TOP) cmp -= PULSE_CNT_TOP;
+        PULSE_CMP = cmp;
+        pulse_wraps = wraps;
+        pulse_state = PULSE_RUNNING;
+        // the compare matches every trip around, so ignore older ones
+        PULSE_INTFLAGS = PULSE_INTFLAG_bm;
+        PULSE_INTCTRL |= PULSE_INT_bm;
+    }
+}
+
+void pulse_stop() {
+    // (set_level() can call this with interrupts already off)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        PULSE_INTCTRL &= ~PULSE_INT_bm;
+        if (pulse_state == PULSE_DONE) PULSE_UNCUT();
+        pulse_state = PULSE_IDLE;
+    }
+}
+
+ISR(PULSE_vect) {
+    // (1-series MCUs don't clear this automatically)
+    PULSE_INTFLAGS = PULSE_INTFLAG_bm;
+    if (pulse_wraps) {
+        pulse_wraps --;
+        return;
+    }
+    PULSE_INTCTRL &= ~PULSE_INT_bm;
+    // other code can enable the interrupt again by accident, when it
+    // changes the same register at the wrong moment, so check first
+    if (pulse_state != PULSE_RUNNING) return;
+    PULSE_CUT();
+    pulse_state = PULSE_DONE;
+    #ifdef FSM_SIM
+    sim_pulse_cut();
+    #endif
+}
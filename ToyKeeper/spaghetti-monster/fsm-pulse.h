@@ -0,0 +1,61 @@
+// fsm-pulse.h: Hardware-timed flashes for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/*
+ * Flashes with a precise length, for strobes.
+ *
+ * pulse_start(level, us) turns on the main emitters at 'level', and a
+ * timer interrupt cuts them off 'us' microseconds later.  The main loop
+ * doesn't have to do anything at the end, so the CPU is free (or dozing)
+ * during the flash, and its length doesn't depend on delay calibration,
+ * clock speed changes, or whatever else the main loop is busy with.
+ *
+ * The cut doesn't go through set_level(), so actual_level still says the
+ * light is on.  The output stays cut until the next set_level() with a
+ * non-zero level, which also cancels any pulse in progress.  Since the
+ * PWM values are still the same, the next pulse at the same level turns
+ * on right away instead of waiting for the PWM cycle to latch them.
+ * set_level(0) leaves the output cut, since it's off either way.
+ *
+ * The hwdef provides a spare timer compare channel:
+ *   PULSE_vect        compare match interrupt
+ *   PULSE_INTCTRL     the register which enables it
+ *   PULSE_INT_bm      ... and the bit to set there
+ *   PULSE_INTFLAGS    the register with its flag
+ *   PULSE_INTFLAG_bm  ... and the bit to clear there
+ *   PULSE_CNT         the timer's counter
+ *   PULSE_CMP         the compare register
+ *   PULSE_CNT_TOP     how many counts before the counter wraps around
+ *   PULSE_US_PER_CNT  how many microseconds each count takes
+ *   PULSE_CUT()       turn off the main emitters immediately, without
+ *                     waiting for the end of a PWM cycle
+ *   PULSE_UNCUT()     undo PULSE_CUT()
+ * The timer must keep running (it can be shared, like an animation
+ * clock in CTC mode, since this only reads the counter).  Pulses are
+ * accurate to one count, and can be up to 65 ms long.
+ *
+ * So far only the Emisar D4v2 hwdef provides this (compare B on timer0,
+ * next to its ms clock).  Everything else keeps the software-timed
+ * strobe frames.  On the 1-series, a TCB in single-shot mode could time
+ * the pulse instead, started by a software event, but that doesn't fit
+ * the shared-counter interface above, and hasn't been tried on hardware.
+ */
+
+// pulse_state
+#define PULSE_IDLE     0
+#define PULSE_RUNNING  1  // on, and the timer will cut it
+#define PULSE_DONE     2  // over, and the output is still cut
+
+volatile uint8_t pulse_state = PULSE_IDLE;
+// full trips around the timer left before the cut
+volatile uint8_t pulse_wraps;
+
+#define pulse_busy() (pulse_state == PULSE_RUNNING)
+
+void pulse_start(uint8_t level, uint16_t us);
+// cancel any pulse, and reconnect the output if it was cut
+// (set_level() does this automatically)
+void pulse_stop();
@@ -81,6 +81,12 @@ void set_level(uint8_t level) {
     set_level_aux_rgb_leds(level);
     #endif
 
+    #ifdef USE_PULSE
+    // a new level cancels any pulse, and undoes its cut
+    // (but off is off, so the output can stay cut)
+    if (level && pulse_state) pulse_stop();
+    #endif
+
     if (0 == level) {
         set_level_zero();
     } else {
@@ -89,6 +95,10 @@ void set_level(uint8_t level) {
         set_level_func(level - 1);
     }
 
+    #ifdef USE_LATENCY_PROBE
+    latency_probe(LP_SET_LEVEL);
+    #endif
+
     if (actual_level != level) prev_level = actual_level;
     actual_level = level;
 
@@ -99,6 +109,10 @@ void set_level(uint8_t level) {
     #ifdef USE_DYNAMIC_UNDERCLOCKING
     auto_clock_speed();
     #endif
+
+    #ifdef FSM_SIM
+    sim_set_level(level);
+    #endif
 }
 
 #ifdef USE_LEGACY_SET_LEVEL
@@ -230,6 +244,104 @@ void set_level_legacy(uint8_t level) {
 #endif
 
 
+#ifdef USE_RAMP_GET
+// look up one level in a packed ramp table
+// (a list of segments, see bin/ramp-pack.py for details)
+// Most lookups are for the same level as last time or the next one, since
+// they come from ramping and gradual ticks, so each table has a cursor
+// which remembers the last lookup, and the search starts from there.
+// (rough estimates, not measured: ~10 cycles per segment skipped, plus
+//  ~10 per step added up in a DELTA segment...  so a few dozen cycles
+//  for the same level or the next one up, and under 1000 cycles in the
+//  worst case, like jumping back to the start of the ramp)
+uint8_t ramp_get(const uint8_t *table, uint8_t level) {
+    // find this table's cursor, or claim an unused one
+    RampGetCursor *c = ramp_get_cursors;
+    while ((c->table != table) && (c->table)
+           && (c < ramp_get_cursors + RAMP_GET_TABLES - 1))
+        c ++;
+    if (c->table != table) {
+        c->table = table;
+        c->seg = table;
+        c->base = 0;
+        c->pos = 255;
+    }
+
+    const uint8_t *p = c->seg;
+    uint8_t base = c->base;
+    // going back before the cursor's segment means starting over
+    if (level < base) {
+        p = table;
+        base = 0;
+    }
+    level -= base;
+    while (1) {
+        const uint8_t *seg = p;
+        uint8_t hdr = pgm_read_byte(p++);
+        uint8_t len = (hdr & 0x3f) + 1;
+        uint8_t type = hdr & 0xc0;
+        if (level < len) {
+            if (seg != c->seg) c->pos = 255;  // cursor's old value is stale
+            c->seg = seg;
+            c->base = base;
+            // raw values
+            if (type == 0x00) return pgm_read_byte(p + level);
+            uint8_t value = pgm_read_byte(p++);
+            // one value for the whole segment
+            if (type == 0x40) return value;
+            // first value, then 4-bit steps, two per byte
+            // (continue from the last lookup, if it wasn't past this one)
+            uint8_t i = 0;
+            if (c->pos <= level) {
+                i = c->pos;
+                value = c->value;
+            }
+            for ( ; i < level; i ++) {
+                uint8_t steps = pgm_read_byte(p + (i >> 1));
+                if (i & 1) steps >>= 4;
+                value += steps & 0x0f;
+            }
+            c->pos = level;
+            c->value = value;
+            return value;
+        }
+        // skip to the next segment
+        level -= len;
+        base += len;
+        if (type == 0x00) p += len;
+        else if (type == 0x40) p += 1;
+        else p += 1 + (len >> 1);
+    }
+}
+#endif
+
+
+#ifdef PWM_TOP_vect
+void set_pwm_top(uint16_t top) {
+    // (interrupts are off, so the ISR can't see a half-written value)
+    pwm_top_next = top;
+    // the flag is probably left over from an old cycle, so clear it
+    // and wait for the next TOP
+    // (the compare values were just written, and they latch at TOP)
+    PWM_TOP_INTFLAGS = PWM_TOP_INTFLAG_bm;
+    PWM_TOP_INTCTRL |= PWM_TOP_INT_bm;
+}
+
+void set_pwm_top_now(uint16_t top) {
+    PWM_TOP_INTCTRL &= ~PWM_TOP_INT_bm;
+    PWM_TOP = top;
+}
+
+// the timer just hit TOP and is counting down now,
+// so any new TOP value is safe until it reaches BOTTOM
+ISR(PWM_TOP_vect) {
+    PWM_TOP = pwm_top_next;
+    // only needed once per change
+    PWM_TOP_INTCTRL &= ~PWM_TOP_INT_bm;
+}
+#endif
+
+
 #ifdef USE_SET_LEVEL_GRADUALLY
 inline void set_level_gradually(uint8_t lvl) {
     gradual_target = lvl;
@@ -98,6 +98,51 @@ void gradual_tick();
 #define PWM_GET8(x,y)  pgm_read_byte(x+y)
 #define PWM_GET16(x,y) pgm_read_word(x+y)
 
+// packed ramp tables, if the build generated them
+// (bin/build.sh does this for targets with USE_PACKED_RAMPS,
+//  see bin/ramp-pack.py for the format)
+// (only for 8-bit PWM, where PWM_GET reads bytes)
+#if defined(USE_PACKED_RAMPS) && defined(PWM_PACKED) && (PWM_BITS <= 8)
+    #define USE_RAMP_GET
+    uint8_t ramp_get(const uint8_t *table, uint8_t level);
+    #undef PWM_GET
+    #define PWM_GET(x,y) ramp_get(x,y)
+    #ifdef PWM1_PACKED
+    PROGMEM const uint8_t pwm1_levels[] = { PWM1_PACKED };
+    #endif
+    #ifdef PWM2_PACKED
+    PROGMEM const uint8_t pwm2_levels[] = { PWM2_PACKED };
+    #endif
+    #ifdef PWM3_PACKED
+    PROGMEM const uint8_t pwm3_levels[] = { PWM3_PACKED };
+    #endif
+    #ifdef PWM4_PACKED
+    PROGMEM const uint8_t pwm4_levels[] = { PWM4_PACKED };
+    #endif
+    #ifdef PWM5_PACKED
+    PROGMEM const uint8_t pwm5_levels[] = { PWM5_PACKED };
+    #endif
+    // ramp_get() remembers its place in each table
+    #if defined(PWM5_PACKED)
+    #define RAMP_GET_TABLES 5
+    #elif defined(PWM4_PACKED)
+    #define RAMP_GET_TABLES 4
+    #elif defined(PWM3_PACKED)
+    #define RAMP_GET_TABLES 3
+    #elif defined(PWM2_PACKED)
+    #define RAMP_GET_TABLES 2
+    #else
+    #define RAMP_GET_TABLES 1
+    #endif
+    typedef struct RampGetCursor {
+        const uint8_t *table;  // which table this is for
+        const uint8_t *seg;    // segment of the last lookup
+        uint8_t base;          // first level in that segment
+        uint8_t pos;           // last level looked up, within the segment
+        uint8_t value;         // ... and what it was (for DELTA segments)
+    } RampGetCursor;
+    RampGetCursor ramp_get_cursors[RAMP_GET_TABLES];
+#else
 // use UI-defined ramp tables if they exist
 #ifdef PWM1_LEVELS
 PROGMEM const PWM1_DATATYPE pwm1_levels[] = { PWM1_LEVELS };
@@ -114,6 +159,7 @@ PROGMEM const PWM4_DATATYPE pwm4_levels[] = { PWM4_LEVELS };
 #ifdef PWM5_LEVELS
 PROGMEM const PWM5_DATATYPE pwm5_levels[] = { PWM5_LEVELS };
 #endif
+#endif  // ifdef USE_RAMP_GET
 
 // convenience defs for 1 LED with stacked channels
 // FIXME: remove this, use pwm1/2/3 instead
@@ -141,6 +187,44 @@ PROGMEM const PWM_DATATYPE blend_pwm_levels[] = { BLEND_PWM_LEVELS };
 PROGMEM const PWM_DATATYPE pwm_tops[] = { PWM_TOPS };
 #endif
 
+// change the dynamic PWM ceiling without flashes
+// If TOP drops below the counter's current value, the counter runs all
+// the way to 65535 before wrapping, which makes a visible flash.  The
+// compare registers are double-buffered and only update at TOP, but
+// on the attiny1634 the TOP register (ICR1) isn't.  So instead of
+// waiting for a safe moment, set_pwm_top() saves the new value, and an
+// interrupt at the next TOP loads it, at the same time the new compare
+// values take effect.
+// To use it, a hwdef defines:
+//   PWM_TOP_vect       interrupt which fires at TOP, like TIMER1_CAPT_vect
+//   PWM_TOP_INTCTRL    the register which enables it
+//   PWM_TOP_INT_bm     ... and the bit to set there
+//   PWM_TOP_INTFLAGS   where to clear its stale flag
+//   PWM_TOP_INTFLAG_bm ... and the bit to clear there
+// Otherwise, TOP is assumed to be double-buffered in hardware (like
+// PERBUF on the attiny 1-series), and it's simply written.
+// The timer's 16-bit registers all share one TEMP byte, so the interrupt
+// writing TOP can corrupt any other 16-bit access it lands in the middle
+// of.  So code which reads or writes CH*_PWM, PWM_CNT, or PWM_TOP on
+// these lights needs to do it inside a PWM_ATOMIC { ... } block, which
+// holds off interrupts until the whole update is done.
+#ifdef PWM_TOP_vect
+#include <util/atomic.h>
+#define PWM_ATOMIC  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+// next TOP value, waiting to be loaded
+volatile uint16_t pwm_top_next;
+// set new TOP, starting at the next timer cycle
+// (call this inside PWM_ATOMIC, right after setting the compare values)
+void set_pwm_top(uint16_t top);
+// set new TOP right now, like when the phase gets reset anyway
+// (and cancel any pending update)
+void set_pwm_top_now(uint16_t top);
+#else
+#define PWM_ATOMIC
+#define set_pwm_top(top)      PWM_TOP = (top)
+#define set_pwm_top_now(top)  PWM_TOP = (top)
+#endif
+
 // FIXME: jump start should be per channel / channel mode
 #ifdef USE_JUMP_START
     #ifndef JUMP_START_TIME
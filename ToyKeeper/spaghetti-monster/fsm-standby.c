@@ -15,11 +15,20 @@
 #define standby_mode sleep_until_eswitch_pressed
 void sleep_until_eswitch_pressed()
 {
+    #ifdef USE_EEPROM_ASYNC
+    // the EEPROM-ready interrupt can't wake the MCU from power-down
+    eeprom_commit_wait();
+    #endif
+
     #ifdef TICK_DURING_STANDBY
-    WDT_slow();
+    WDT_slow(STANDBY_TICK_SPEED);
     #else
     WDT_off();
     #endif
+    #ifdef USE_SLOW_TICKS
+    tick_scale = 1;  // sleep ticks are counted one at a time
+    tick_slow_ok = 0;  // (until the state asks for longer ones)
+    #endif
 
     ADC_off();
 
@@ -72,6 +81,9 @@ void sleep_until_eswitch_pressed()
         }
         if (irq_wdt) {  // generate a sleep tick
             WDT_inner();
+            #ifdef USE_ADAPTIVE_SLEEP_TICK
+            if (go_to_standby) sleep_tick_next();
+            #endif
         }
     }
     #endif
@@ -83,7 +95,10 @@ void sleep_until_eswitch_pressed()
     // go back to normal running mode
     // PCINT not needed any more, and can cause problems if on
     // (occasional reboots on wakeup-by-button-press)
+    // (except when it's used to time button edges while awake)
+    #ifndef USE_BUTTON_EDGE_TIMING
     PCINT_off();
+    #endif
     // restore normal awake-mode interrupts
     ADC_on();
     WDT_on();
@@ -95,11 +110,32 @@ void idle_mode()
     // configure sleep mode
     set_sleep_mode(SLEEP_MODE_IDLE);
 
-    sleep_enable();
-    sleep_cpu();  // wait here
+    // only sleep if nothing is waiting to be handled
+    // (check with interrupts off, so nothing new can sneak in before
+    //  sleep_cpu()...  the instruction after sei() always runs first)
+    cli();
+    if ((emissions_head == emissions_tail)
+        && (! deferred_state) && (! go_to_standby)
+        && (! irq_wdt) && (! irq_adc)
+        #ifdef USE_ADAPTIVE_TICK
+        && (! irq_pcint)
+        #endif
+        #ifdef USE_BUTTON_EDGE_TIMING
+        && (! irq_button_edge)
+        #endif
+        #ifdef USE_ANIMATION
+        // (a frame may have come due after anim_run() checked)
+        && ((! anim_busy()) || (anim_left > 0))
+        #endif
+        ) {
+        sleep_enable();
+        sei();
+        sleep_cpu();  // wait here
 
-    // something happened; wake up
-    sleep_disable();
+        // something happened; wake up
+        sleep_disable();
+    }
+    sei();
 }
 #endif
 
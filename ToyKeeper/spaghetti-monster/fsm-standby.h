@@ -55,14 +55,23 @@ volatile uint8_t go_to_standby = 0;
 #define SLEEP_TICKS_PER_MINUTE 57
 
 #endif
+
+// how many regular ticks each sleep tick counts as
+#define SLEEP_TICK_SCALE (1 << STANDBY_TICK_SPEED)
 #endif
 
 #define standby_mode sleep_until_eswitch_pressed
 void sleep_until_eswitch_pressed();
 
+// the main loop dozes between interrupts when there's nothing to do
+// (define DONT_USE_IDLE_MODE to keep it running at full speed instead)
+#if !defined(USE_IDLE_MODE) && !defined(DONT_USE_IDLE_MODE)
+#define USE_IDLE_MODE
+#endif
+
 #ifdef USE_IDLE_MODE
-// stops processing until next click or timer tick
-// (I think)
+// stops processing until the next interrupt (like a timer tick),
+// unless some event or interrupt is still waiting to be handled
 void idle_mode();
 #endif
 
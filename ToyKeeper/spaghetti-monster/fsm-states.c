@@ -17,6 +17,11 @@
 
 void _set_state(StatePtr new_state, uint16_t arg,
                 Event exit_event, Event enter_event) {
+    #ifdef USE_ANIMATION
+    // stop the old state's animation
+    // (before the hooks, so the new state can start its own)
+    anim_interrupt();
+    #endif
     // call old state-exit hook (don't use stack)
     if (current_state != NULL) current_state(exit_event, arg);
     // set new state
@@ -28,11 +33,28 @@ void _set_state(StatePtr new_state, uint16_t arg,
     interrupt_nice_delays();
 }
 
+#ifdef USE_EVENT_DISPATCH_TABLE
+// look up which kinds of events a state handles
+// (only done when pushing a state, not on every event)
+uint8_t state_event_kinds(StatePtr state) {
+    const StateEvents *se = state_events;
+    StatePtr s;
+    while ((s = (StatePtr)pgm_read_ptr(&(se->state)))) {
+        if (s == state) return pgm_read_byte(&(se->kinds));
+        se ++;
+    }
+    return EVK_ALL;
+}
+#endif
+
 int8_t push_state(StatePtr new_state, uint16_t arg) {
     if (state_stack_len < STATE_STACK_SIZE) {
         // TODO: call old state's exit hook?
         //       new hook for non-exit recursion into child?
         state_stack[state_stack_len] = new_state;
+        #ifdef USE_EVENT_DISPATCH_TABLE
+        state_stack_kinds[state_stack_len] = state_event_kinds(new_state);
+        #endif
         state_stack_len ++;
         // FIXME: use EV_stacked_state?
         _set_state(new_state, arg, EV_leave_state, EV_enter_state);
@@ -19,6 +19,24 @@ volatile StatePtr current_state;
 StatePtr state_stack[STATE_STACK_SIZE];
 uint8_t state_stack_len = 0;
 
+#ifdef USE_EVENT_DISPATCH_TABLE
+// The UI lists which kinds of events (EVK_*) each state can handle,
+// so emit_now() can skip over states which would just fall through.
+// States not in the list get every event, and the list ends with NULL:
+//   const StateEvents state_events[] PROGMEM = {
+//       { my_state, EVK_BUTTON | EVK_TICK },
+//       { NULL, EVK_ALL }
+//   };
+typedef struct StateEvents {
+    StatePtr state;
+    uint8_t kinds;
+} StateEvents;
+extern const StateEvents state_events[] PROGMEM;
+// event kinds handled by each state on the stack
+uint8_t state_stack_kinds[STATE_STACK_SIZE];
+uint8_t state_event_kinds(StatePtr state);
+#endif
+
 void _set_state(StatePtr new_state, uint16_t arg,
                 Event exit_event, Event enter_event);
 int8_t push_state(StatePtr new_state, uint16_t arg);
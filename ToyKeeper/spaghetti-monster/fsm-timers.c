@@ -0,0 +1,61 @@
+// fsm-timers.c: Software timers for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "fsm-timers.h"
+
+void timer_start(Timer *t, uint16_t ticks, uint16_t period) {
+    timer_stop(t);
+    t->period = period;
+
+    // find its place in line, counting down the ticks on the way
+    Timer **p = &timers;
+    while (*p && ((*p)->delta <= ticks)) {
+        ticks -= (*p)->delta;
+        p = &((*p)->next);
+    }
+    // the one after it is now due relative to this one
+    if (*p) (*p)->delta -= ticks;
+
+    t->delta = ticks;
+    t->next = *p;
+    *p = t;
+    t->active = 1;
+}
+
+void timer_stop(Timer *t) {
+    if (! t->active) return;
+    Timer **p = &timers;
+    while (*p != t) p = &((*p)->next);
+    *p = t->next;
+    // give its time to the next one, so that one stays on schedule
+    if (t->next) t->next->delta += t->delta;
+    t->active = 0;
+}
+
+uint16_t timer_left(Timer *t) {
+    if (! t->active) return 0;
+    uint16_t ticks = 0;
+    for (Timer *i = timers;  ; i = i->next) {
+        ticks += i->delta;
+        if (i == t) return ticks;
+    }
+}
+
+void timers_tick(uint16_t ticks) {
+    Timer *t;
+    // pop each timer which is due
+    // (a slow tick can make several due at once, or a periodic timer
+    //  due more than once, and the leftover time carries over to the
+    //  next one in line, so none of them drift)
+    while ((t = timers) && (t->delta <= ticks)) {
+        ticks -= t->delta;
+        timers = t->next;
+        t->active = 0;
+        if (t->id) emit(EV_timer, t->id);
+        if (t->period) timer_start(t, t->period, t->period);
+    }
+    if (t) t->delta -= ticks;
+}
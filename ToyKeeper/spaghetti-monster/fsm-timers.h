@@ -0,0 +1,53 @@
+// fsm-timers.h: Software timers for SpaghettiMonster.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/*
+ * Timeouts and countdowns, counted in WDT ticks (TICKS_PER_SECOND).
+ *
+ * Instead of counting EV_tick and EV_sleep_tick events in each state, a
+ * UI can start a timer, and the FSM emits EV_timer when it's due.  The
+ * arg is the timer's id, so one handler can tell several timers apart.
+ * A timer with a period starts over each time it's due; otherwise it
+ * only happens once.
+ *
+ * Active timers are kept in a list sorted by when they're due, and each
+ * one only stores how many ticks after the one before it.  So each tick
+ * only counts down the first timer, no matter how many are running, and
+ * timers_next() says how long until anything needs to happen.
+ *
+ * Each Timer belongs to the UI, usually as a global with its id set:
+ *   Timer my_timer = { .id = MY_TIMER_ID };
+ * An id of 0 doesn't emit anything, for timers which are only checked
+ * with timer_active() (like a rate limit).
+ *
+ * Timers count while asleep too, if TICK_DURING_STANDBY is enabled, but
+ * they're only checked once per sleep tick then.  Without it, they stop
+ * during standby.  Each timer can count up to 65535 ticks (17 minutes),
+ * so longer timeouts should use a periodic timer and count the periods.
+ */
+
+typedef struct Timer {
+    struct Timer *next;  // the timer due after this one
+    uint16_t delta;      // ticks after the one before it is due
+    uint16_t period;     // start over with this many ticks (0 = one-shot)
+    uint8_t id;          // arg for EV_timer (0 = no event)
+    uint8_t active;
+} Timer;
+
+// the first timer due, or NULL
+Timer *timers = NULL;
+
+// start (or restart) a timer, due 'ticks' from now
+void timer_start(Timer *t, uint16_t ticks, uint16_t period);
+void timer_stop(Timer *t);
+#define timer_active(t) ((t)->active)
+// how many ticks until a timer is due (0 if it's not running)
+uint16_t timer_left(Timer *t);
+
+// let some ticks pass, and emit events for any timers which are due
+void timers_tick(uint16_t ticks);
+// how many ticks until the next timer is due (0xffff if none)
+#define timers_next() (timers ? timers->delta : 0xffff)
@@ -30,29 +30,106 @@ void WDT_on()
     #else
         #error Unrecognized MCU type
     #endif
+    #ifdef USE_SLOW_TICKS
+    tick_scale = 1;
+    #endif
 }
 
+#ifdef USE_ADAPTIVE_TICK
+// tick slower while awake, and let the button speed it up again
+inline void WDT_awake_slow()
+{
+    #if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85)
+        wdt_reset();                    // Reset the WDT
+        WDTCR |= (1<<WDCE) | (1<<WDE);  // Start timed sequence
+        WDTCR = (1<<WDIE) | AWAKE_SLOW_TICK_SPEED;
+    #elif (ATTINY == 1634)
+        wdt_reset();                    // Reset the WDT
+        WDTCSR = (1<<WDIE) | AWAKE_SLOW_TICK_SPEED;
+    #elif defined(AVRXMEGA3)  // ATTINY816, 817, etc
+        while (RTC.PITSTATUS > 0) {}  // make sure the register is ready to be updated
+        // each step after CYC512 doubles the period
+        RTC.PITCTRLA = (RTC_PERIOD_CYC512_gc + (AWAKE_SLOW_TICK_SPEED<<3))
+                     | RTC_PITEN_bm;
+    #else
+        #error Unrecognized MCU type
+    #endif
+    tick_scale = 1 << AWAKE_SLOW_TICK_SPEED;
+
+    // WDT won't notice the button quickly any more, so let PCINT do it
+    PCINT_on();
+    irq_pcint = 0;  // (ignore any old pin change from before)
+}
+
+// go back to the normal tick speed, if it was slow
+void tick_fast() {
+    if (tick_scale > 1) {
+        WDT_on();
+        #ifndef USE_BUTTON_EDGE_TIMING
+        PCINT_off();
+        #endif
+    }
+}
+#endif
+
 #ifdef TICK_DURING_STANDBY
-inline void WDT_slow()
+// speed: 0 = 16 ms, and each step up doubles the period
+inline void WDT_slow(uint8_t speed)
 {
+    #if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85) || (ATTINY == 1634)
+        // the top prescaler bit (WDP3) isn't next to the others
+        speed = (speed & 0x07) | ((speed & 0x08) << 2);
+    #endif
     #if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85)
         // interrupt slower
         //cli();                          // Disable interrupts
         wdt_reset();                    // Reset the WDT
         WDTCR |= (1<<WDCE) | (1<<WDE);  // Start timed sequence
-        WDTCR = (1<<WDIE) | STANDBY_TICK_SPEED; // Enable interrupt every so often
+        WDTCR = (1<<WDIE) | speed;      // Enable interrupt every so often
         //sei();                          // Enable interrupts
     #elif (ATTINY == 1634)
         wdt_reset();                    // Reset the WDT
-        WDTCSR = (1<<WDIE) | STANDBY_TICK_SPEED;
+        WDTCSR = (1<<WDIE) | speed;
     #elif defined(AVRXMEGA3)  // ATTINY816, 817, etc
         RTC.PITINTCTRL = RTC_PI_bm;   // enable the Periodic Interrupt
         while (RTC.PITSTATUS > 0) {}  // make sure the register is ready to be updated
-        RTC.PITCTRLA = (1<<6) | (STANDBY_TICK_SPEED<<3) | RTC_PITEN_bm; // Set period, enable the PI Timer
+        RTC.PITCTRLA = (1<<6) | (speed<<3) | RTC_PITEN_bm; // Set period, enable the PI Timer
     #else
         #error Unrecognized MCU type
     #endif
 }
+
+#ifdef USE_ADAPTIVE_SLEEP_TICK
+// pick how long to sleep until the next sleep tick
+// (call after each sleep tick is handled)
+void sleep_tick_next() {
+    // how many regular sleep ticks until something needs to happen
+    uint16_t ticks = 1;
+    if (tick_slow_ok) {
+        ticks = 0xffff;
+        #ifdef USE_TIMERS
+        ticks = timers_next() / SLEEP_TICK_SCALE;
+        #endif
+        #ifdef USE_SLEEP_LVP
+        // measure the battery each tick at first, then every 16 ticks
+        uint16_t since = ticks_since_last_event;
+        uint8_t lvp = 1;
+        if (since > (8 * SLEEP_TICKS_PER_SECOND)) lvp = 16 - (since & 0x0f);
+        if (lvp < ticks) ticks = lvp;
+        #endif
+    }
+    tick_slow_ok = 0;  // the state needs to ask again each tick
+
+    // sleep the longest power-of-two number of ticks which fits
+    uint8_t steps = 0;
+    while (((2 << steps) <= ticks)
+           && ((STANDBY_TICK_SPEED + steps) < STANDBY_TICK_SPEED_MAX)
+           && (steps < 7))  // (tick_scale is 8 bits)
+        steps ++;
+    WDT_slow(STANDBY_TICK_SPEED + steps);
+    tick_scale = 1 << steps;
+}
+#endif
 #endif
 
 inline void WDT_off()
@@ -87,6 +164,10 @@ ISR(RTC_PIT_vect) {
 ISR(WDT_vect) {
 #endif
     irq_wdt = 1;  // WDT event happened
+
+    #if defined(USE_LATENCY_PROBE) && !defined(AVRXMEGA3) && !defined(FSM_SIM)
+    latency_ticks += tick_scale;
+    #endif
 }
 
 void WDT_inner() {
@@ -94,27 +175,59 @@ void WDT_inner() {
 
     static uint8_t adc_trigger = 0;
 
+    // how many normal ticks this one counts as
+    // (cached, since the tick speed can change below)
+    uint8_t scale = tick_scale;
+    #ifdef USE_ADAPTIVE_TICK
+    if (tick_cut_short) {
+        // the WDT can't say how much of the slow tick went by, so count
+        // half of it...  that's right on average, so timers don't fall
+        // behind a little more at each button press
+        tick_cut_short = 0;
+        scale >>= 1;
+        tick_fast();
+    }
+    #endif
+
     // cache this here to reduce ROM size, because it's volatile
     uint16_t ticks_since_last = ticks_since_last_event;
     // increment, but loop from max back to half
-    ticks_since_last = (ticks_since_last + 1) \
+    ticks_since_last = (ticks_since_last + scale) \
                      | (ticks_since_last & 0x8000);
     // copy back to the original
     ticks_since_last_event = ticks_since_last;
 
     // detect and emit button change events (even during standby)
+    #ifdef USE_BUTTON_EDGE_TIMING
+    // (but not while the switch may still be bouncing from the last change)
+    if (button_debounce) button_debounce --;
+    else {
+    #endif
     uint8_t was_pressed = button_last_state;
     uint8_t pressed = button_is_pressed();
     if (was_pressed != pressed) {
+        #ifdef USE_LATENCY_PROBE
+        latency_probe(LP_WDT);
+        #endif
         go_to_standby = 0;
         PCINT_inner(pressed);
+        #ifdef USE_BUTTON_EDGE_TIMING
+        button_debounce = BUTTON_DEBOUNCE_TICKS;
+        #endif
     }
+    #ifdef USE_BUTTON_EDGE_TIMING
+    }
+    #endif
     // cache again, in case the value changed
     ticks_since_last = ticks_since_last_event;
 
     #ifdef TICK_DURING_STANDBY
     // handle standby mode specially
     if (go_to_standby) {
+        #ifdef USE_TIMERS
+        // (timers first, so the tick sees what they changed)
+        timers_tick(SLEEP_TICK_SCALE * scale);
+        #endif
         // emit a sleep tick, and process it
         emit(EV_sleep_tick, ticks_since_last);
         process_emissions();
@@ -124,8 +237,10 @@ void WDT_inner() {
         #else
         // stop here, usually...  except during the first few seconds asleep, 
         // and once in a while afterward for sleep LVP
+        // (a long sleep tick can skip over a multiple of 16, so check
+        //  whether this tick passed one)
         if ((ticks_since_last > (8 * SLEEP_TICKS_PER_SECOND))
-            && (0 != (ticks_since_last & 0x0f))) return;
+            && ((ticks_since_last & 0x0f) >= scale)) return;
 
         adc_trigger = 0;  // make sure a measurement will happen
         adc_active_now = 1;  // use ADC noise reduction sleep mode
@@ -135,10 +250,25 @@ void WDT_inner() {
     else {  // button handling should only happen while awake
     #endif
 
+    #ifdef USE_ADAPTIVE_TICK
+    // tick slower if the state asked for it during the last tick,
+    // but only while no button input is in progress
+    if (tick_slow_ok && (! current_event)) {
+        if (tick_scale == 1) WDT_awake_slow();
+    }
+    else tick_fast();
+    tick_slow_ok = 0;  // the state needs to ask again each tick
+    #endif
+
     // if time since last event exceeds timeout,
     // append timeout to current event sequence, then
     // send event to current state callback
 
+    #ifdef USE_TIMERS
+    // (timers first, so the tick sees what they changed)
+    timers_tick(scale);
+    #endif
+
     // callback on each timer tick
     if ((current_event & B_FLAGS) == (B_CLICK | B_HOLD | B_PRESS)) {
         emit(EV_tick, 0);  // override tick counter while holding button
@@ -191,7 +321,7 @@ void WDT_inner() {
         adc_deferred_enable = 1;
     }
     // timing for the ADC handler is every 32 ticks (~2Hz)
-    adc_trigger = (adc_trigger + 1) & 31;
+    adc_trigger = (adc_trigger + scale) & 31;
     #endif
 }
 
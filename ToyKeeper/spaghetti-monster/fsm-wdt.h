@@ -5,16 +5,70 @@
 #pragma once
 
 #define TICKS_PER_SECOND 62
+#define TICKS_PER_MINUTE (TICKS_PER_SECOND*60)
 
 void WDT_on();
 inline void WDT_off();
 
 volatile uint8_t irq_wdt = 0;  // WDT interrupt happened?
 
+#ifdef USE_ADAPTIVE_SLEEP_TICK
+// in standby, sleep through as many sleep ticks as possible, until the
+// next thing which needs to happen...  but only when the current state
+// says it doesn't need every frame, with allow_slow_ticks()
+// (needs TICK_DURING_STANDBY, and uses tick_scale for the longer ticks)
+// the longest the WDT / PIT can sleep
+#ifndef STANDBY_TICK_SPEED_MAX
+#ifdef AVRXMEGA3
+#define STANDBY_TICK_SPEED_MAX 6  // 1.0 s
+#else
+#define STANDBY_TICK_SPEED_MAX 9  // 8.0 s
+#endif
+#endif
+#endif
+
+// either kind of slow tick needs these
+#if defined(USE_ADAPTIVE_TICK) || defined(USE_ADAPTIVE_SLEEP_TICK)
+#define USE_SLOW_TICKS
+#endif
+
+#ifdef USE_SLOW_TICKS
+// how many normal (16 ms) ticks the current tick counts as
+// (code which counts EV_tick events should add this instead of 1,
+//  and code which checks an EV_tick arg should use >= instead of ==)
+uint8_t tick_scale = 1;
+// set this while handling EV_tick to allow slow ticks until the next one
+// (it gets cleared each tick, so a state has to keep asking)
+uint8_t tick_slow_ok = 0;
+#define allow_slow_ticks() (tick_slow_ok = 1)
+#else
+#define tick_scale 1
+#endif
+
+#ifdef USE_ADAPTIVE_TICK
+// while awake, the clock can tick slower when the current state has
+// no per-frame work to do...  to save power in long-running modes
+// (uses the same prescaler values as STANDBY_TICK_SPEED, up to 5)
+#ifndef AWAKE_SLOW_TICK_SPEED
+#define AWAKE_SLOW_TICK_SPEED 3  // every 0.128 s
+#endif
+#if (AWAKE_SLOW_TICK_SPEED < 1) || (AWAKE_SLOW_TICK_SPEED > 5)
+#error AWAKE_SLOW_TICK_SPEED must be 1 to 5
+#endif
+inline void WDT_awake_slow();
+void tick_fast();
+// a button press woke the MCU before the slow tick was over
+uint8_t tick_cut_short = 0;
+#endif
+
 #ifdef TICK_DURING_STANDBY
   #if defined(USE_INDICATOR_LED) || defined(USE_AUX_RGB_LEDS)
   // measure battery charge while asleep
   #define USE_SLEEP_LVP
   #endif
+inline void WDT_slow(uint8_t speed);
+#ifdef USE_ADAPTIVE_SLEEP_TICK
+void sleep_tick_next();
+#endif
 #endif
 
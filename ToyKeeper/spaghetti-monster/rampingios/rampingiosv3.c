@@ -1243,11 +1243,4 @@ void loop() {
     }
     #endif
 
-    #ifdef USE_IDLE_MODE
-    else {
-        // doze until next clock tick
-        idle_mode();
-    }
-    #endif
-
 }
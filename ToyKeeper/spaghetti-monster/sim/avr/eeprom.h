@@ -0,0 +1,11 @@
+// sim/avr/eeprom.h: Host stand-in for avr-libc's <avr/eeprom.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <avr/io.h>
+
+// EEPROM contents live in the simulator, and survive reboots
+uint8_t eeprom_read_byte(const uint8_t *addr);
+void eeprom_write_byte(uint8_t *addr, uint8_t value);
+void eeprom_update_byte(uint8_t *addr, uint8_t value);
@@ -0,0 +1,15 @@
+// sim/avr/interrupt.h: Host stand-in for avr-libc's <avr/interrupt.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <avr/io.h>
+
+#define ISR(vector, ...) void vector(void)
+#define ISR_NAKED
+#define ISR_NOBLOCK
+#define reti() return
+
+// global interrupt flag, tracked by the simulator
+void cli();
+void sei();
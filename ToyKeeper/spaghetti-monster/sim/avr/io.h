@@ -0,0 +1,351 @@
+// sim/avr/io.h: Host stand-in for avr-libc's <avr/io.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+/*
+ * This is only used by the host simulator (see sim/sim.txt).
+ * Every I/O register is a plain global variable, and the simulator in
+ * sim/sim.c decides what the "hardware" does with the values written.
+ *
+ * Only the classic register layout is supported:
+ *   - attiny25 / 45 / 85
+ *   - attiny1634
+ * The 1-series (attiny416, 816, 1616, etc) uses struct-based peripherals
+ * and has not been mapped yet.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if !defined(ATTINY)
+#error The simulator needs ATTINY defined before <avr/io.h>.
+#endif
+
+// the UI's main() becomes a function the simulator calls
+#define main fsm_main
+
+#define _BV(bit) (1 << (bit))
+
+// 8-bit and 16-bit registers
+#define SIM_REG8(name)  volatile uint8_t  name
+#define SIM_REG16(name) volatile uint16_t name
+
+// registers with side effects when read (defined in sim/sim.c)
+volatile uint8_t  * sim_read_pin(uint8_t port);
+volatile uint8_t  * sim_read_tcnt0();
+volatile uint16_t * sim_read_tcnt1();
+#define PINA (*sim_read_pin(0))
+#define PINB (*sim_read_pin(1))
+#define PINC (*sim_read_pin(2))
+
+SIM_REG8(PORTA); SIM_REG8(DDRA); SIM_REG8(PUEA);
+SIM_REG8(PORTB); SIM_REG8(DDRB); SIM_REG8(PUEB);
+SIM_REG8(PORTC); SIM_REG8(DDRC); SIM_REG8(PUEC);
+
+SIM_REG8(GIMSK);
+SIM_REG8(MCUCR);
+SIM_REG8(MCUSR);
+SIM_REG8(CLKPR);
+SIM_REG8(CCP);
+SIM_REG8(PRR);
+SIM_REG8(TIMSK);
+SIM_REG8(TIFR);
+SIM_REG8(GTCCR);
+
+SIM_REG8(TCCR0A); SIM_REG8(TCCR0B);
+#define TCNT0 (*sim_read_tcnt0())
+SIM_REG8(OCR0A);  SIM_REG8(OCR0B);
+
+SIM_REG8(ADMUX);
+SIM_REG8(ADCSRA); SIM_REG8(ADCSRB);
+SIM_REG16(ADC);
+#define ADCL ((uint8_t)(ADC & 0xff))
+#define ADCH ((uint8_t)(ADC >> 8))
+SIM_REG8(DIDR0);  SIM_REG8(DIDR1); SIM_REG8(DIDR2);
+
+SIM_REG8(EECR);   SIM_REG8(EEDR);
+SIM_REG16(EEAR);
+
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+
+#define PCINT0  0
+#define PCINT1  1
+#define PCINT2  2
+#define PCINT3  3
+#define PCINT4  4
+#define PCINT5  5
+#define PCINT6  6
+#define PCINT7  7
+#define PCINT8  0
+#define PCINT9  1
+#define PCINT10 2
+#define PCINT11 3
+#define PCINT12 0
+#define PCINT13 1
+#define PCINT14 2
+#define PCINT15 3
+#define PCINT16 4
+#define PCINT17 5
+
+// MCUSR
+#define PORF  0
+#define EXTRF 1
+#define BORF  2
+#define WDRF  3
+
+// WDTCR / WDTCSR
+#define WDP0 0
+#define WDP1 1
+#define WDP2 2
+#define WDE  3
+#define WDCE 4
+#define WDP3 5
+#define WDIE 6
+#define WDIF 7
+
+// TCCR0A / TCCR0B
+#define WGM00  0
+#define WGM01  1
+#define COM0B0 4
+#define COM0B1 5
+#define COM0A0 6
+#define COM0A1 7
+#define CS00   0
+#define CS01   1
+#define CS02   2
+#define WGM02  3
+#define FOC0B  6
+#define FOC0A  7
+
+// ADCSRA
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADIE  3
+#define ADIF  4
+#define ADATE 5
+#define ADSC  6
+#define ADEN  7
+
+// ADMUX
+#define MUX0  0
+#define MUX1  1
+#define MUX2  2
+#define MUX3  3
+#define REFS0 6
+#define REFS1 7
+
+// EECR
+#define EERE  0
+#define EEPE  1
+#define EEMPE 2
+#define EERIE 3
+#define EEPM0 4
+#define EEPM1 5
+
+#define CLKPCE 7
+
+
+#if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85)
+
+    #if (ATTINY == 25)
+    #define E2END 127
+    #elif (ATTINY == 45)
+    #define E2END 255
+    #else
+    #define E2END 511
+    #endif
+
+    SIM_REG8(WDTCR);
+    #define SIM_WDT_REG WDTCR
+    SIM_REG8(PCMSK);
+
+    SIM_REG8(TCCR1);
+    SIM_REG8(TCNT1);
+    SIM_REG8(OCR1A); SIM_REG8(OCR1B); SIM_REG8(OCR1C);
+
+    // GIMSK
+    #define PCIE 5
+    #define INT0 6
+
+    // MCUCR
+    #define ISC00 0
+    #define ISC01 1
+    #define BODSE 2
+    #define SM0   3
+    #define SM1   4
+    #define SE    5
+    #define PUD   6
+    #define BODS  7
+
+    // TCCR1
+    #define CS10   0
+    #define CS11   1
+    #define CS12   2
+    #define CS13   3
+    #define COM1A0 4
+    #define COM1A1 5
+    #define PWM1A  6
+    #define CTC1   7
+
+    // GTCCR
+    #define PSR0   0
+    #define PSR1   1
+    #define FOC1A  2
+    #define FOC1B  3
+    #define COM1B0 4
+    #define COM1B1 5
+    #define PWM1B  6
+    #define TSM    7
+
+    // TIMSK / TIFR
+    #define TOIE0  1
+    #define TOIE1  2
+    #define OCIE0B 3
+    #define OCIE0A 4
+    #define OCIE1B 5
+    #define OCIE1A 6
+    #define TOV0   1
+    #define TOV1   2
+    #define OCF0B  3
+    #define OCF0A  4
+    #define OCF1B  5
+    #define OCF1A  6
+
+    // ADMUX
+    #define REFS2 4
+    #define ADLAR 5
+
+    // DIDR0
+    #define AIN0D 0
+    #define AIN1D 1
+    #define ADC1D 2
+    #define ADC3D 3
+    #define ADC2D 4
+    #define ADC0D 5
+
+#elif (ATTINY == 1634)
+
+    #define E2END 255
+
+    SIM_REG8(WDTCSR);
+    #define SIM_WDT_REG WDTCSR
+    SIM_REG8(PCMSK0); SIM_REG8(PCMSK1); SIM_REG8(PCMSK2);
+
+    SIM_REG8(TCCR1A); SIM_REG8(TCCR1B); SIM_REG8(TCCR1C);
+    #define TCNT1 (*sim_read_tcnt1())
+    SIM_REG16(ICR1);
+    SIM_REG16(OCR1A); SIM_REG16(OCR1B);
+
+    // GIMSK
+    #define PCIE0 3
+    #define PCIE1 4
+    #define PCIE2 5
+    #define INT0  6
+
+    // TCCR1A / TCCR1B
+    #define WGM10  0
+    #define WGM11  1
+    #define COM1B0 4
+    #define COM1B1 5
+    #define COM1A0 6
+    #define COM1A1 7
+    #define CS10   0
+    #define CS11   1
+    #define CS12   2
+    #define WGM12  3
+    #define WGM13  4
+    #define ICES1  6
+    #define ICNC1  7
+
+    // TIMSK / TIFR
+    #define OCIE0A 0
+    #define TOIE0  1
+    #define OCIE0B 2
+    #define ICIE1  3
+    #define OCIE1B 5
+    #define OCIE1A 6
+    #define TOIE1  7
+    #define OCF0A  0
+    #define TOV0   1
+    #define OCF0B  2
+    #define ICF1   3
+    #define OCF1B  5
+    #define OCF1A  6
+    #define TOV1   7
+
+    // ADCSRB
+    #define ADLAR 3
+
+    // DIDR0 / DIDR1 / DIDR2
+    #define ADC0D  1
+    #define ADC1D  2
+    #define ADC2D  3
+    #define ADC3D  4
+    #define ADC4D  5
+    #define ADC5D  6
+    #define ADC6D  7
+    #define ADC7D  0
+    #define ADC8D  1
+    #define ADC9D  2
+    #define ADC10D 3
+    #define ADC11D 0
+
+#else
+    #error The simulator does not support this MCU yet.
+#endif
+
+#define EEPSIZE (E2END+1)
+
+// interrupt vectors, as function names
+// (weak, so the simulator can tell which ones the program defined)
+#define SIM_VECTOR(name) void name(void) __attribute__((weak))
+#define PCINT0_vect       sim_vect_pcint0
+#define PCINT1_vect       sim_vect_pcint1
+#define PCINT2_vect       sim_vect_pcint2
+#define WDT_vect          sim_vect_wdt
+#define ADC_vect          sim_vect_adc
+#define EE_RDY_vect       sim_vect_ee_rdy
+#define TIMER0_OVF_vect   sim_vect_timer0_ovf
+#define TIMER1_OVF_vect   sim_vect_timer1_ovf
+#define TIMER1_COMPA_vect sim_vect_timer1_compa
+#define TIMER0_COMPA_vect sim_vect_timer0_compa
+#define TIMER0_COMPB_vect sim_vect_timer0_compb
+#define TIMER1_CAPT_vect  sim_vect_timer1_capt
+SIM_VECTOR(PCINT0_vect);
+SIM_VECTOR(PCINT1_vect);
+SIM_VECTOR(PCINT2_vect);
+SIM_VECTOR(WDT_vect);
+SIM_VECTOR(ADC_vect);
+SIM_VECTOR(EE_RDY_vect);
+SIM_VECTOR(TIMER0_OVF_vect);
+SIM_VECTOR(TIMER1_OVF_vect);
+SIM_VECTOR(TIMER1_COMPA_vect);
+SIM_VECTOR(TIMER0_COMPA_vect);
+SIM_VECTOR(TIMER0_COMPB_vect);
+SIM_VECTOR(TIMER1_CAPT_vect);
+
+// hooks the FSM calls when built with -DFSM_SIM
+void sim_set_level(uint8_t level);
+void sim_pulse_cut();
+void sim_main_loop();
@@ -0,0 +1,19 @@
+// sim/avr/pgmspace.h: Host stand-in for avr-libc's <avr/pgmspace.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <stdint.h>
+
+// host has one flat address space, so flash is just memory
+#define PROGMEM
+
+// ... except when code reads raw flash addresses (like pseudo_rand() does),
+// which gets some arbitrary but repeatable bytes instead
+static inline uint8_t sim_pgm_read_byte(uintptr_t addr) {
+    if (addr < 0x10000) return (uint8_t)((addr * 2654435761u) >> 24);
+    return *(const uint8_t *)addr;
+}
+#define pgm_read_byte(addr) sim_pgm_read_byte((uintptr_t)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_ptr(addr) (*(void * const *)(addr))
@@ -0,0 +1,24 @@
+// sim/avr/power.h: Host stand-in for avr-libc's <avr/power.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <avr/io.h>
+
+#if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85)
+typedef enum
+{
+    clock_div_1 = 0,
+    clock_div_2 = 1,
+    clock_div_4 = 2,
+    clock_div_8 = 3,
+    clock_div_16 = 4,
+    clock_div_32 = 5,
+    clock_div_64 = 6,
+    clock_div_128 = 7,
+    clock_div_256 = 8
+} clock_div_t;
+
+// the tiny1634 version is in tk-attiny.h, and writes CLKPR directly
+#define clock_prescale_set(x) (CLKPR = (x))
+#endif
@@ -0,0 +1,19 @@
+// sim/avr/sleep.h: Host stand-in for avr-libc's <avr/sleep.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE     0
+#define SLEEP_MODE_ADC      1
+#define SLEEP_MODE_PWR_DOWN 2
+
+uint8_t sim_sleep_mode;
+#define set_sleep_mode(mode) (sim_sleep_mode = (mode))
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_bod_disable()
+
+// skip ahead to the next interrupt
+void sleep_cpu();
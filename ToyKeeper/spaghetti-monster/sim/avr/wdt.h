@@ -0,0 +1,12 @@
+// sim/avr/wdt.h: Host stand-in for avr-libc's <avr/wdt.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <avr/io.h>
+
+#define WDTO_15MS 0
+
+void sim_wdt_reset();
+#define wdt_reset() sim_wdt_reset()
+#define wdt_disable() (SIM_WDT_REG = 0)
@@ -0,0 +1,697 @@
+// sim.c: Host-native simulator for SpaghettiMonster UIs.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*
+ * Builds a UI (like anduril.c) as a regular Linux program, with the AVR
+ * hardware replaced by a model driven by virtual time.  See sim.txt.
+ *
+ * Like the firmware itself, this is all one compilation unit.  The UI
+ * gets included first, so the simulator can see its config (switch pin,
+ * ADC calibration, etc), then the simulated hardware goes below it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tk.h"
+#include incfile(SIM_PROGRAM)
+
+#undef main
+
+
+/********* simulated hardware state *********/
+
+#define SIM_NEVER (~(uint64_t)0)
+#define SIM_NS_PER_CYCLE (1000000000.0 / F_CPU)
+
+uint64_t sim_ns = 0;  // virtual time since power was connected
+uint8_t sim_sreg_i = 0;  // global interrupt enable flag
+uint32_t sim_isr_count = 0;
+
+volatile uint8_t sim_pins[3];
+int8_t sim_switch_port = -1;
+uint8_t sim_button = 0;
+float sim_volts = 4.0;
+int16_t sim_temp_c = 25;
+
+uint8_t sim_eeprom[EEPSIZE];
+const char *sim_eeprom_file = NULL;
+
+// interrupt flags which haven't been serviced yet
+uint8_t sim_pending_pcint = 0;
+uint8_t sim_pending_wdt = 0;
+uint8_t sim_pending_adc = 0;
+uint8_t sim_pending_timer = 0;
+uint8_t sim_pending_timer0_compa = 0;
+uint8_t sim_pending_timer0_compb = 0;
+
+// when each hardware source fires next
+uint64_t sim_wdt_next = SIM_NEVER;
+uint8_t sim_wdt_reg_seen = 0;
+uint64_t sim_adc_next = SIM_NEVER;
+uint64_t sim_timer_next = SIM_NEVER;
+uint64_t sim_timer0a_next = SIM_NEVER;  // timer0 compare matches,
+uint64_t sim_timer0b_next = SIM_NEVER;  // in CTC mode
+uint64_t sim_eeprom_next = SIM_NEVER;  // when the current write finishes
+
+// timer0 in CTC mode runs all the time, so its count is worked out from
+// the last time it was 0 (and it keeps its place when the clock changes)
+double sim_timer0_ns = 0;  // ns per count, or 0 if not in CTC mode
+uint64_t sim_timer0_base = 0;  // when the count was 0
+uint8_t sim_timer0_seen[3];  // settings the next matches are based on
+
+// light output, for measuring flashes
+uint8_t sim_light = 0;
+uint8_t sim_measuring = 0;
+uint64_t sim_light_rise = SIM_NEVER;  // last time it turned on
+
+typedef struct SimStat {
+    uint32_t count;
+    uint64_t sum, min, max;
+} SimStat;
+SimStat sim_stat_on, sim_stat_period;
+uint64_t sim_measure_start;
+uint64_t sim_asleep_ns;  // time spent in sleep_cpu() since then
+uint32_t sim_wakeups;  // ... and how many times it woke up
+uint64_t sim_asleep_since = SIM_NEVER;  // while in sleep_cpu()
+
+
+/********* input script *********/
+
+typedef enum {
+    SIM_WAIT, SIM_PRESS, SIM_RELEASE, SIM_TOGGLE, SIM_VOLTS, SIM_TEMP,
+    SIM_MEASURE, SIM_REPORT, SIM_QUIT
+} SimAction;
+
+typedef struct SimStep {
+    SimAction action;
+    float arg;
+} SimStep;
+
+SimStep *sim_steps = NULL;
+uint32_t sim_steps_len = 0;
+uint32_t sim_steps_cap = 0;
+uint32_t sim_step = 0;
+uint64_t sim_script_next = 0;
+
+// quick clicks, short enough to chain into multi-click events
+#define SIM_CLICK_MS 64
+#define SIM_BOUNCE_MS 0.5
+
+static void sim_add_step(SimAction action, float arg) {
+    if (sim_steps_len == sim_steps_cap) {
+        sim_steps_cap = sim_steps_cap ? (sim_steps_cap * 2) : 64;
+        sim_steps = realloc(sim_steps, sim_steps_cap * sizeof(SimStep));
+        if (! sim_steps) { perror("realloc"); exit(1); }
+    }
+    sim_steps[sim_steps_len].action = action;
+    sim_steps[sim_steps_len].arg = arg;
+    sim_steps_len ++;
+}
+
+static void sim_load_script(FILE *fp) {
+    char line[256];
+    uint32_t lineno = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        lineno ++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = 0;
+
+        char cmd[32];
+        float arg = 0;
+        int n = sscanf(line, "%31s %f", cmd, &arg);
+        if (n < 1) continue;
+
+        if (! strcmp(cmd, "wait")) {
+            sim_add_step(SIM_WAIT, arg);
+        } else if (! strcmp(cmd, "press")) {
+            sim_add_step(SIM_PRESS, 0);
+        } else if (! strcmp(cmd, "release")) {
+            sim_add_step(SIM_RELEASE, 0);
+        } else if (! strcmp(cmd, "click")) {
+            if (n < 2) arg = 1;
+            for (int i=0; i<(int)arg; i++) {
+                sim_add_step(SIM_PRESS, 0);
+                sim_add_step(SIM_WAIT, SIM_CLICK_MS);
+                sim_add_step(SIM_RELEASE, 0);
+                sim_add_step(SIM_WAIT, SIM_CLICK_MS);
+            }
+        } else if (! strcmp(cmd, "hold")) {
+            sim_add_step(SIM_PRESS, 0);
+            sim_add_step(SIM_WAIT, arg);
+            sim_add_step(SIM_RELEASE, 0);
+        } else if (! strcmp(cmd, "bounce")) {
+            if (n < 2) arg = 1;
+            for (int i=0; i<(int)arg; i++) {
+                sim_add_step(SIM_TOGGLE, 0);
+                sim_add_step(SIM_WAIT, SIM_BOUNCE_MS);
+                sim_add_step(SIM_TOGGLE, 0);
+                sim_add_step(SIM_WAIT, SIM_BOUNCE_MS);
+            }
+        } else if ((! strcmp(cmd, "volts")) && (n == 2)) {
+            sim_add_step(SIM_VOLTS, arg);
+        } else if ((! strcmp(cmd, "temp")) && (n == 2)) {
+            sim_add_step(SIM_TEMP, arg);
+        } else if (! strcmp(cmd, "measure")) {
+            sim_add_step(SIM_MEASURE, 0);
+        } else if (! strcmp(cmd, "report")) {
+            sim_add_step(SIM_REPORT, 0);
+        } else if (! strcmp(cmd, "quit")) {
+            sim_add_step(SIM_QUIT, 0);
+        } else {
+            fprintf(stderr, "script line %u: unknown command '%s'\n",
+                    lineno, cmd);
+            exit(1);
+        }
+    }
+}
+
+
+/********* output *********/
+
+static double sim_ms() {
+    return sim_ns / 1000000.0;
+}
+
+static void sim_quit(uint8_t code) {
+    printf("%12.3f  end\n", sim_ms());
+    if (sim_eeprom_file) {
+        FILE *fp = fopen(sim_eeprom_file, "wb");
+        if (fp) {
+            fwrite(sim_eeprom, 1, sizeof(sim_eeprom), fp);
+            fclose(fp);
+        }
+    }
+    exit(code);
+}
+
+static void sim_stat_add(SimStat *stat, uint64_t ns) {
+    if ((! stat->count) || (ns < stat->min)) stat->min = ns;
+    if ((! stat->count) || (ns > stat->max)) stat->max = ns;
+    stat->sum += ns;
+    stat->count ++;
+}
+
+static void sim_light_set(uint8_t on) {
+    if (on == sim_light) return;
+    sim_light = on;
+    if (! sim_measuring) return;
+    if (on) {
+        if (sim_light_rise != SIM_NEVER)
+            sim_stat_add(&sim_stat_period, sim_ns - sim_light_rise);
+        sim_light_rise = sim_ns;
+    }
+    else if (sim_light_rise != SIM_NEVER) {
+        sim_stat_add(&sim_stat_on, sim_ns - sim_light_rise);
+    }
+}
+
+static void sim_measure() {
+    memset(&sim_stat_on, 0, sizeof(sim_stat_on));
+    memset(&sim_stat_period, 0, sizeof(sim_stat_period));
+    sim_light_rise = SIM_NEVER;
+    sim_measure_start = sim_ns;
+    sim_asleep_ns = 0;
+    sim_wakeups = 0;
+    // (the script runs during sleep_cpu(), so it may be asleep now)
+    if (sim_asleep_since != SIM_NEVER) sim_asleep_since = sim_ns;
+    sim_measuring = 1;
+}
+
+// flash length and spacing since "measure", with the range for each
+static void sim_report() {
+    SimStat *on = &sim_stat_on, *period = &sim_stat_period;
+    printf("%12.3f  report %u flashes", sim_ms(), on->count);
+    if (on->count) {
+        printf(", on %.3f ms (%.3f to %.3f)",
+               on->sum / 1e6 / on->count, on->min / 1e6, on->max / 1e6);
+    }
+    if (on->count && period->count) {
+        double avg = (double)period->sum / period->count;
+        printf(", period %.3f ms (%.3f to %.3f), duty %.2f%%",
+               avg / 1e6, period->min / 1e6, period->max / 1e6,
+               100.0 * on->sum / on->count / avg);
+    }
+    if (sim_asleep_since != SIM_NEVER) {
+        sim_asleep_ns += sim_ns - sim_asleep_since;
+        sim_asleep_since = sim_ns;
+    }
+    if (sim_ns > sim_measure_start) {
+        printf(", asleep %.1f%% (%u wakeups)",
+               100.0 * sim_asleep_ns / (sim_ns - sim_measure_start),
+               sim_wakeups);
+    }
+    printf("\n");
+    sim_measuring = 0;
+}
+
+void sim_set_level(uint8_t level) {
+    printf("%12.3f  set_level %u\n", sim_ms(), level);
+    sim_light_set(level > 0);
+}
+
+// a hardware-timed flash just ended (see fsm-pulse.h)
+void sim_pulse_cut() {
+    printf("%12.3f  pulse_cut\n", sim_ms());
+    sim_light_set(0);
+}
+
+#ifdef USE_LATENCY_PROBE
+uint16_t sim_latency_clock() {
+    return (uint16_t)(sim_ns / 10000);
+}
+
+void sim_latency_probe(uint8_t stage) {
+    static const char *names[] = {
+        "isr", "wdt", "emit", "emit_now", "set_level" };
+    printf("%12.3f  probe %s\n", sim_ms(), names[stage]);
+}
+#endif
+
+
+/********* interrupts *********/
+
+static void sim_call_isr(void (*isr)(void)) {
+    if (! isr) return;
+    sim_isr_count ++;
+    sim_sreg_i = 0;  // no nested interrupts, like real hardware
+    isr();
+    sim_sreg_i = 1;
+}
+
+static void sim_service_interrupts() {
+    if (! sim_sreg_i) return;
+    // in vector table order
+    if (sim_pending_pcint) {
+        sim_pending_pcint = 0;
+        sim_call_isr(PCINT0_vect);
+        sim_call_isr(PCINT1_vect);
+        sim_call_isr(PCINT2_vect);
+    }
+    if (sim_pending_wdt) {
+        sim_pending_wdt = 0;
+        SIM_WDT_REG &= ~(1 << WDIF);
+        sim_call_isr(WDT_vect);
+    }
+    if (sim_pending_timer) {
+        sim_pending_timer = 0;
+        if (TIMSK & (1 << TOIE1)) sim_call_isr(TIMER1_OVF_vect);
+        if (TIMSK & (1 << OCIE1A)) sim_call_isr(TIMER1_COMPA_vect);
+        if (TIMSK & (1 << TOIE0)) sim_call_isr(TIMER0_OVF_vect);
+        #ifdef ICIE1
+        if (TIMSK & (1 << ICIE1)) sim_call_isr(TIMER1_CAPT_vect);
+        #endif
+    }
+    if (sim_pending_timer0_compa) {
+        sim_pending_timer0_compa = 0;
+        sim_call_isr(TIMER0_COMPA_vect);
+    }
+    if (sim_pending_timer0_compb) {
+        sim_pending_timer0_compb = 0;
+        sim_call_isr(TIMER0_COMPB_vect);
+    }
+    if (sim_pending_adc) {
+        sim_pending_adc = 0;
+        sim_call_isr(ADC_vect);
+    }
+    // (EEPROM ready fires for as long as it's enabled and not writing)
+    if ((EECR & (1 << EERIE)) && !(EECR & (1 << EEPE))) {
+        sim_call_isr(EE_RDY_vect);
+    }
+}
+
+void cli() { sim_sreg_i = 0; }
+
+void sei() {
+    sim_sreg_i = 1;
+    sim_service_interrupts();
+}
+
+
+/********* peripherals *********/
+
+static uint8_t sim_pcint_enabled() {
+    #if (ATTINY == 25) || (ATTINY == 45) || (ATTINY == 85)
+    return (GIMSK & (1 << PCIE)) && (PCMSK & (1 << SWITCH_PIN));
+    #else
+    return (GIMSK & (1 << SWITCH_PCIE)) && (SWITCH_PCMSK & (1 << SWITCH_PCINT));
+    #endif
+}
+
+static uint64_t sim_wdt_period() {
+    uint8_t reg = SIM_WDT_REG;
+    uint8_t prescale = (reg & 0x07) | ((reg >> 2) & 0x08);
+    return (uint64_t)16000000 << prescale;
+}
+
+static uint8_t sim_clock_div() {
+    return 1 << (CLKPR & 0x0f);
+}
+
+// timer0 in CTC mode: counts from 0 to OCR0A, then starts over
+// returns ns per count, or 0 if it's stopped or in another mode
+static double sim_timer0_count_ns() {
+    static const uint16_t prescale[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+    if ((TCCR0A & ((1 << WGM01) | (1 << WGM00))) != (1 << WGM01)) return 0;
+    if (TCCR0B & (1 << WGM02)) return 0;
+    return prescale[TCCR0B & 0x07] * sim_clock_div() * SIM_NS_PER_CYCLE;
+}
+
+// the next time timer0's count moves past 'value', after now
+static uint64_t sim_timer0_match(uint8_t value) {
+    if ((! sim_timer0_ns) || (value > OCR0A)) return SIM_NEVER;
+    double period = (OCR0A + 1) * sim_timer0_ns;
+    double t = sim_timer0_base + ((value + 1) * sim_timer0_ns);
+    if (t <= sim_ns) t += ((uint64_t)((sim_ns - t) / period) + 1) * period;
+    // (round up, so it's never before the match)
+    uint64_t ns = t;
+    return (ns < t) ? (ns + 1) : ns;
+}
+
+static void sim_adc_convert() {
+    uint16_t raw;
+    #ifdef ADMUX_THERM
+    if ((ADMUX & 0x0f) == (ADMUX_THERM & 0x0f)) {
+        raw = sim_temp_c + 275;
+    } else
+    #endif
+    {
+        #ifdef USE_VOLTAGE_DIVIDER
+        raw = sim_volts * 10 * (ADC_44 - ADC_22) / 22;
+        #else
+        raw = 1.1 * 1024 / sim_volts;
+        #endif
+    }
+    if (raw > 1023) raw = 1023;
+
+    #if (ATTINY == 1634)
+    uint8_t left = ADCSRB & (1 << ADLAR);
+    #else
+    uint8_t left = ADMUX & (1 << ADLAR);
+    #endif
+    ADC = left ? (raw << 6) : raw;
+}
+
+// notice when the program reconfigures a peripheral
+static void sim_check_peripherals() {
+    uint8_t wdt = SIM_WDT_REG & ((1 << WDIE) | (1 << WDE)
+                                 | (1 << WDP3) | 0x07);
+    if (wdt != sim_wdt_reg_seen) {
+        sim_wdt_reg_seen = wdt;
+        sim_wdt_next = wdt ? (sim_ns + sim_wdt_period()) : SIM_NEVER;
+    }
+
+    uint8_t adc_running = (ADCSRA & (1 << ADEN))
+                       && (ADCSRA & ((1 << ADSC) | (1 << ADATE)));
+    if (! adc_running) sim_adc_next = SIM_NEVER;
+    else if (sim_adc_next == SIM_NEVER) {
+        // 13 ADC clocks per conversion
+        uint8_t prescale = 1 << ((ADCSRA & 0x07) ? (ADCSRA & 0x07) : 1);
+        sim_adc_next = sim_ns + (uint64_t)(13 * prescale * sim_clock_div()
+                                           * SIM_NS_PER_CYCLE);
+    }
+
+    uint8_t timer_ints = TIMSK & ((1 << TOIE0) | (1 << TOIE1) | (1 << OCIE1A)
+                                  #ifdef ICIE1
+                                  | (1 << ICIE1)
+                                  #endif
+                                  );
+    if (! timer_ints) sim_timer_next = SIM_NEVER;
+    else if (sim_timer_next == SIM_NEVER)
+        sim_timer_next = sim_ns + (uint64_t)(512 * SIM_NS_PER_CYCLE);
+
+    double t0_ns = sim_timer0_count_ns();
+    uint8_t t0_ints = TIMSK & ((1 << OCIE0A) | (1 << OCIE0B));
+    if (t0_ns != sim_timer0_ns) {
+        if (t0_ns && sim_timer0_ns) {
+            // the timer runs on the CPU clock, so after a clock speed
+            // change, it counts slower or faster from the same place
+            double count = (sim_ns - sim_timer0_base) / sim_timer0_ns;
+            count -= (uint64_t)(count / (OCR0A + 1)) * (OCR0A + 1);
+            sim_timer0_base = sim_ns - (uint64_t)(count * t0_ns);
+        }
+        else sim_timer0_base = sim_ns;
+        sim_timer0_ns = t0_ns;
+        sim_timer0_seen[0] = ~t0_ints;  // find the next matches again
+    }
+    if ((t0_ints != sim_timer0_seen[0])
+            || (OCR0A != sim_timer0_seen[1])
+            || (OCR0B != sim_timer0_seen[2])) {
+        sim_timer0_seen[0] = t0_ints;
+        sim_timer0_seen[1] = OCR0A;
+        sim_timer0_seen[2] = OCR0B;
+        sim_timer0a_next = (t0_ints & (1 << OCIE0A))
+                         ? sim_timer0_match(OCR0A) : SIM_NEVER;
+        sim_timer0b_next = (t0_ints & (1 << OCIE0B))
+                         ? sim_timer0_match(OCR0B) : SIM_NEVER;
+    }
+}
+
+// "wdr" instruction: restart the WDT's countdown
+void sim_wdt_reset() {
+    if (sim_wdt_next != SIM_NEVER) sim_wdt_next = sim_ns + sim_wdt_period();
+}
+
+static void sim_set_button(uint8_t pressed) {
+    if (pressed == sim_button) return;
+    sim_button = pressed;
+    printf("%12.3f  %s\n", sim_ms(), pressed ? "press" : "release");
+    if (sim_pcint_enabled()) sim_pending_pcint = 1;
+}
+
+static void sim_run_script() {
+    while (sim_script_next <= sim_ns) {
+        if (sim_step >= sim_steps_len) sim_quit(0);
+        SimStep *s = sim_steps + (sim_step ++);
+        switch (s->action) {
+            case SIM_WAIT:
+                sim_script_next = sim_ns + (uint64_t)(s->arg * 1000000);
+                break;
+            case SIM_PRESS:   sim_set_button(1); break;
+            case SIM_RELEASE: sim_set_button(0); break;
+            case SIM_TOGGLE:  sim_set_button(! sim_button); break;
+            case SIM_VOLTS:   sim_volts = s->arg; break;
+            case SIM_TEMP:    sim_temp_c = s->arg; break;
+            case SIM_MEASURE: sim_measure(); break;
+            case SIM_REPORT:  sim_report(); break;
+            case SIM_QUIT:    sim_quit(0); break;
+        }
+    }
+}
+
+// handle everything due at the current time
+static void sim_fire_events() {
+    sim_check_peripherals();
+
+    if (sim_script_next <= sim_ns) sim_run_script();
+
+    if (sim_wdt_next <= sim_ns) {
+        sim_wdt_next = sim_ns + sim_wdt_period();
+        if (SIM_WDT_REG & (1 << WDIE)) {
+            sim_pending_wdt = 1;
+            SIM_WDT_REG |= (1 << WDIF);
+        }
+        else if (SIM_WDT_REG & (1 << WDE)) {
+            printf("%12.3f  reboot\n", sim_ms());
+            sim_quit(0);
+        }
+    }
+
+    if (sim_adc_next <= sim_ns) {
+        sim_adc_convert();
+        ADCSRA &= ~(1 << ADSC);
+        sim_adc_next = SIM_NEVER;
+        if (ADCSRA & (1 << ADIE)) sim_pending_adc = 1;
+    }
+
+    if (sim_timer_next <= sim_ns) {
+        sim_timer_next = SIM_NEVER;
+        sim_pending_timer = 1;
+    }
+
+    if (sim_timer0a_next <= sim_ns) {
+        sim_timer0a_next = sim_timer0_match(OCR0A);
+        sim_pending_timer0_compa = 1;
+    }
+
+    if (sim_timer0b_next <= sim_ns) {
+        sim_timer0b_next = sim_timer0_match(OCR0B);
+        sim_pending_timer0_compb = 1;
+    }
+
+    if (sim_eeprom_next <= sim_ns) {
+        sim_eeprom_next = SIM_NEVER;
+        EECR &= ~(1 << EEPE);
+    }
+
+    sim_service_interrupts();
+    sim_check_peripherals();
+}
+
+static uint64_t sim_next_event() {
+    uint64_t next = sim_script_next;
+    if (sim_wdt_next < next) next = sim_wdt_next;
+    if (sim_adc_next < next) next = sim_adc_next;
+    if (sim_timer_next < next) next = sim_timer_next;
+    if (sim_timer0a_next < next) next = sim_timer0a_next;
+    if (sim_timer0b_next < next) next = sim_timer0b_next;
+    if (sim_eeprom_next < next) next = sim_eeprom_next;
+    return next;
+}
+
+// let some virtual time pass, running interrupts as they come due
+static void sim_advance(uint64_t ns) {
+    uint64_t target = sim_ns + ns;
+    sim_check_peripherals();
+    for (uint64_t next = sim_next_event();
+         next <= target;
+         next = sim_next_event()) {
+        if (next > sim_ns) sim_ns = next;
+        sim_fire_events();
+    }
+    sim_ns = target;
+}
+
+static void sim_advance_cycles(uint32_t cycles) {
+    sim_advance((uint64_t)(cycles * sim_clock_div() * SIM_NS_PER_CYCLE));
+}
+
+void sleep_cpu() {
+    // sleeping with interrupts off would hang the real thing too
+    if (! sim_sreg_i) {
+        printf("%12.3f  sleep with interrupts disabled\n", sim_ms());
+        sim_quit(1);
+    }
+    uint32_t count = sim_isr_count;
+    sim_asleep_since = sim_ns;
+    while (count == sim_isr_count) {
+        sim_check_peripherals();
+        uint64_t next = sim_next_event();
+        if (next > sim_ns) sim_ns = next;
+        sim_fire_events();
+    }
+    sim_asleep_ns += sim_ns - sim_asleep_since;
+    sim_asleep_since = SIM_NEVER;
+    sim_wakeups ++;
+}
+
+void _delay_loop_2(uint16_t count) {
+    sim_advance_cycles(count ? (count * 4) : (65536 * 4));
+}
+
+void _delay_ms(double ms) {
+    sim_advance((uint64_t)(ms * sim_clock_div() * 1000000));
+}
+
+// a trip through the main loop isn't free
+void sim_main_loop() {
+    sim_advance_cycles(100);
+}
+
+volatile uint8_t * sim_read_pin(uint8_t port) {
+    sim_advance_cycles(1);
+    uint8_t value = 0xff;
+    if ((port == sim_switch_port) && sim_button)
+        value &= ~(1 << SWITCH_PIN);
+    sim_pins[port] = value;
+    return sim_pins + port;
+}
+
+volatile uint8_t * sim_read_tcnt0() {
+    static uint8_t tcnt;
+    sim_advance_cycles(1);
+    if (sim_timer0_ns) {
+        uint64_t count = (sim_ns - sim_timer0_base) / sim_timer0_ns;
+        tcnt = count % (OCR0A + 1);
+    } else {
+        // other modes aren't modeled, so just keep it moving
+        tcnt = (uint64_t)(sim_ns / SIM_NS_PER_CYCLE) % 256;
+    }
+    return &tcnt;
+}
+
+volatile uint16_t * sim_read_tcnt1() {
+    static uint16_t tcnt;
+    sim_advance_cycles(1);
+    #if (ATTINY == 1634)
+    uint16_t top = ICR1 ? ICR1 : 255;
+    #else
+    uint16_t top = 255;
+    #endif
+    tcnt = (uint64_t)(sim_ns / SIM_NS_PER_CYCLE) % (top + 1);
+    return &tcnt;
+}
+
+
+/********* EEPROM *********/
+
+// like avr-libc, wait for any write in progress before the next access
+static void sim_eeprom_wait() {
+    if (sim_eeprom_next != SIM_NEVER)
+        sim_advance((sim_eeprom_next > sim_ns) ? (sim_eeprom_next - sim_ns) : 0);
+}
+
+uint8_t eeprom_read_byte(const uint8_t *addr) {
+    sim_eeprom_wait();
+    return sim_eeprom[(uintptr_t)addr % EEPSIZE];
+}
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value) {
+    sim_eeprom_wait();
+    sim_eeprom[(uintptr_t)addr % EEPSIZE] = value;
+    // erase + write takes about 3.4 ms, in the background
+    EECR |= (1 << EEPE);
+    sim_eeprom_next = sim_ns + 3400000;
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value) {
+    if (eeprom_read_byte(addr) != value) eeprom_write_byte(addr, value);
+}
+
+
+/********* entry point *********/
+
+static void sim_usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-e eeprom.bin] [script]\n", name);
+    fprintf(stderr, "Reads a button / battery script from stdin by default.\n");
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    const char *script = NULL;
+    for (int i=1; i<argc; i++) {
+        if (! strcmp(argv[i], "-e")) {
+            if (++i >= argc) sim_usage(argv[0]);
+            sim_eeprom_file = argv[i];
+        }
+        else if (argv[i][0] == '-') sim_usage(argv[0]);
+        else script = argv[i];
+    }
+
+    FILE *fp = stdin;
+    if (script) {
+        fp = fopen(script, "r");
+        if (! fp) { perror(script); return 1; }
+    }
+    sim_load_script(fp);
+    if (fp != stdin) fclose(fp);
+
+    // blank EEPROM, unless a saved image exists
+    memset(sim_eeprom, 0xff, sizeof(sim_eeprom));
+    if (sim_eeprom_file) {
+        FILE *efp = fopen(sim_eeprom_file, "rb");
+        if (efp) {
+            size_t got = fread(sim_eeprom, 1, sizeof(sim_eeprom), efp);
+            (void)got;
+            fclose(efp);
+        }
+    }
+
+    // find out which port the e-switch is on
+    sim_switch_port = &SWITCH_PORT - sim_pins;
+
+    fsm_main();
+    return 0;
+}
@@ -0,0 +1,28 @@
+// sim/util/atomic.h: Host stand-in for avr-libc's <util/atomic.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <avr/interrupt.h>
+
+// global interrupt flag, tracked by the simulator
+extern uint8_t sim_sreg_i;
+
+static inline uint8_t sim_atomic_cli() { cli(); return 1; }
+static inline void sim_atomic_restore(const uint8_t *was_on) {
+    if (*was_on) sei();
+    else cli();
+}
+static inline void sim_atomic_on(const uint8_t *unused) { (void)unused; sei(); }
+
+// same shape as avr-libc: the block runs once with interrupts off, and
+// leaving it (even with return or break) restores them
+#define ATOMIC_BLOCK(type) \
+    for (type, sim_atomic_todo = sim_atomic_cli(); sim_atomic_todo; \
+         sim_atomic_todo = 0)
+#define ATOMIC_RESTORESTATE \
+    uint8_t sim_atomic_sreg __attribute__((__cleanup__(sim_atomic_restore))) \
+        = sim_sreg_i
+#define ATOMIC_FORCEON \
+    uint8_t sim_atomic_sreg __attribute__((__cleanup__(sim_atomic_on))) = 0
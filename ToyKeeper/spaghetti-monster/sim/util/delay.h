@@ -0,0 +1,8 @@
+// sim/util/delay.h: Host stand-in for avr-libc's <util/delay.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <util/delay_basic.h>
+
+void _delay_ms(double ms);
@@ -0,0 +1,10 @@
+// sim/util/delay_basic.h: Host stand-in for avr-libc's <util/delay_basic.h>.
+// Copyright (C) 2026 agent
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <stdint.h>
+
+// 4 CPU cycles per count, like the real thing
+// (0 means 65536, also like the real thing)
+void _delay_loop_2(uint16_t count);
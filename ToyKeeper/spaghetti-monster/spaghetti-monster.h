@@ -23,14 +23,32 @@
 #include "fsm-states.h"
 #include "fsm-adc.h"
 #include "fsm-wdt.h"
+#ifdef USE_TIMERS
+#include "fsm-timers.h"
+#endif
+#ifdef MS_CLOCK_vect
+#include "fsm-clock.h"
+#endif
 #include "fsm-pcint.h"
 #include "fsm-standby.h"
 #include "fsm-channels.h"
+#ifdef USE_DELTA_SIGMA
+#include "fsm-dsm.h"
+#endif
 #include "fsm-ramping.h"
+#ifdef USE_ANIMATION
+#include "fsm-anim.h"
+#endif
+#ifdef USE_PULSE
+#include "fsm-pulse.h"
+#endif
 #include "fsm-random.h"
 #ifdef USE_EEPROM
 #include "fsm-eeprom.h"
 #endif
+#ifdef USE_LATENCY_PROBE
+#include "fsm-latency.h"
+#endif
 #include "fsm-misc.h"
 #include "fsm-main.h"
 
@@ -62,14 +80,32 @@ void loop();
 #include "fsm-events.c"
 #include "fsm-adc.c"
 #include "fsm-wdt.c"
+#ifdef USE_TIMERS
+#include "fsm-timers.c"
+#endif
+#ifdef MS_CLOCK_vect
+#include "fsm-clock.c"
+#endif
 #include "fsm-pcint.c"
 #include "fsm-standby.c"
 #include "fsm-channels.c"
+#ifdef USE_DELTA_SIGMA
+#include "fsm-dsm.c"
+#endif
 #include "fsm-ramping.c"
+#ifdef USE_ANIMATION
+#include "fsm-anim.c"
+#endif
+#ifdef USE_PULSE
+#include "fsm-pulse.c"
+#endif
 #include "fsm-random.c"
 #ifdef USE_EEPROM
 #include "fsm-eeprom.c"
 #endif
 #include "fsm-misc.c"
 #include "fsm-main.c"
+#ifdef USE_LATENCY_PROBE
+#include "fsm-latency.c"
+#endif
 
@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Like build.sh, but builds a SpaghettiMonster UI as a native program
+# for the host simulator, instead of a hex file for the MCU.
+# (see ToyKeeper/spaghetti-monster/sim/sim.txt)
+
+if [ -z "$1" ]; then
+  echo "Usage: build-sim.sh MCU myprogram [flags]"
+  echo "MCU is a number, like '85' for attiny85 or '1634' for attiny1634"
+  echo "Run it from the UI's directory, like build.sh."
+  exit
+fi
+
+export ATTINY=$1 ; shift
+export PROGRAM=$1 ; shift
+
+SERIES1=' 416 417 816 817 1616 1617 3216 3217 '
+if [[ $SERIES1 =~ " $ATTINY " ]]; then
+  echo "The simulator does not support ATtiny$ATTINY yet."
+  exit 1
+fi
+
+# the simulator's avr/*.h headers must come before the real ones
+SIMDIR=$(dirname "$0")/../ToyKeeper/spaghetti-monster/sim
+
+export CC=${SIM_CC:-gcc}
+export CFLAGS="-Wall -g -O1 -std=gnu99 -fgnu89-inline -fshort-enums -Wno-int-to-pointer-cast -DATTINY=$ATTINY -DFSM_SIM -I$SIMDIR -I. -I.. -I../.. -I../../.."
+
+for arg in "$*" ; do
+  OTHERFLAGS="$OTHERFLAGS $arg"
+done
+
+function run () {
+  echo $*
+  $*
+  if [ x"$?" != x0 ]; then exit 1 ; fi
+}
+
+# generate and pack ramp tables the same way build.sh does
+MACROS=$($CC $OTHERFLAGS $CFLAGS -DSIM_PROGRAM=$PROGRAM.c -E -dM $SIMDIR/sim.c 2> /dev/null)
+if echo "$MACROS" | grep -q '^#define RAMP_SPEC\b' ; then
+  echo "$MACROS" | $(dirname "$0")/ramp-gen.py $PROGRAM.levels.h $PROGRAM.levels.txt || exit 1
+  OTHERFLAGS="$OTHERFLAGS -include $PROGRAM.levels.h"
+  MACROS=$($CC $OTHERFLAGS $CFLAGS -DSIM_PROGRAM=$PROGRAM.c -E -dM $SIMDIR/sim.c 2> /dev/null)
+fi
+if echo "$MACROS" | grep -q '^#define USE_PACKED_RAMPS\b' ; then
+  echo "$MACROS" | $(dirname "$0")/ramp-pack.py > $PROGRAM.ramps.h || exit 1
+  OTHERFLAGS="$OTHERFLAGS -include $PROGRAM.ramps.h"
+fi
+
+run $CC $OTHERFLAGS $CFLAGS -DSIM_PROGRAM=$PROGRAM.c -o $PROGRAM.sim $SIMDIR/sim.c
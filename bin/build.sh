@@ -35,7 +35,10 @@ export CPPFLAGS="-Wall -g -Os -mmcu=$MCU -C -std=gnu99 -fgnu89-inline -fwhole-pr
 export OFLAGS="-Wall -g -Os -mmcu=$MCU -mrelax $DFPFLAGS"
 export LDFLAGS="-fgnu89-inline"
 export OBJCOPYFLAGS='--set-section-flags=.eeprom=alloc,load --change-section-lma .eeprom=0 --no-change-warnings -O ihex --remove-section .fuse'
-export OBJS=$PROGRAM.o
+# output file names default to the program name,
+# but can be set per build so several builds can run at once
+export OUT=${OUT:-$PROGRAM}
+export OBJS=$OUT.o
 
 for arg in "$*" ; do
   OTHERFLAGS="$OTHERFLAGS $arg"
@@ -47,11 +50,43 @@ function run () {
   if [ x"$?" != x0 ]; then exit 1 ; fi
 }
 
-run $CPP $OTHERFLAGS $CPPFLAGS -o foo.cpp $PROGRAM.c
-grep -a -E -v '^#|^$' foo.cpp > $PROGRAM.cpp ; rm foo.cpp
-run $CC $OTHERFLAGS $CFLAGS -o $PROGRAM.o -c $PROGRAM.c
-run $CC $OFLAGS $LDFLAGS -o $PROGRAM.elf $PROGRAM.o
-run $OBJCOPY $OBJCOPYFLAGS $PROGRAM.elf $PROGRAM.hex
+# generate ramp tables from the target's RAMP_SPEC, if it has one
+# (see bin/ramp-gen.py, which also writes a report of each level)
+MACROS=$($CPP $OTHERFLAGS $CPPFLAGS -dM $PROGRAM.c 2> /dev/null)
+if echo "$MACROS" | grep -q '^#define RAMP_SPEC\b' ; then
+  echo "$MACROS" | $(dirname "$0")/ramp-gen.py $OUT.levels.h $OUT.levels.txt || exit 1
+  OTHERFLAGS="$OTHERFLAGS -include $OUT.levels.h"
+  MACROS=$($CPP $OTHERFLAGS $CPPFLAGS -dM $PROGRAM.c 2> /dev/null)
+fi
+
+# pack ramp tables smaller, if the target asks for it
+# (see bin/ramp-pack.py)
+if echo "$MACROS" | grep -q '^#define USE_PACKED_RAMPS\b' ; then
+  echo "$MACROS" | $(dirname "$0")/ramp-pack.py > $OUT.ramps.h || exit 1
+  OTHERFLAGS="$OTHERFLAGS -include $OUT.ramps.h"
+fi
+
+run $CPP $OTHERFLAGS $CPPFLAGS -o $OUT.foo.cpp $PROGRAM.c
+grep -a -E -v '^#|^$' $OUT.foo.cpp > $OUT.cpp ; rm $OUT.foo.cpp
+
+# with INCREMENTAL set, skip the compile if the preprocessed source
+# and flags are the same as last time
+if [ -n "$INCREMENTAL" ]; then
+  HASH=$( (echo $OTHERFLAGS $CFLAGS $OFLAGS $LDFLAGS ; cat $OUT.cpp) | md5sum | cut -d ' ' -f 1 )
+  if [ -f $OUT.hex ] && [ -f $OUT.elf ] && [ x"$HASH" = x"$(cat $OUT.hash 2> /dev/null)" ]; then
+    echo "$OUT.hex is up to date"
+    exit 0
+  fi
+  rm -f $OUT.hash
+fi
+
+run $CC $OTHERFLAGS $CFLAGS -o $OUT.o -c $PROGRAM.c
+run $CC $OFLAGS $LDFLAGS -o $OUT.elf $OUT.o
+run $OBJCOPY $OBJCOPYFLAGS $OUT.elf $OUT.hex
 # deprecated
-#run avr-size -C --mcu=$MCU $PROGRAM.elf | grep Full
-run avr-objdump -Pmem-usage $PROGRAM.elf | grep Full
+#run avr-size -C --mcu=$MCU $OUT.elf | grep Full
+run avr-objdump -Pmem-usage $OUT.elf | grep Full
+
+if [ -n "$INCREMENTAL" ]; then
+  echo $HASH > $OUT.hash
+fi
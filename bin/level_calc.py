@@ -16,6 +16,21 @@ dyn_pwm = False
 def main(args):
     """Calculates PWM levels for visually-linear steps.
     """
+    answers, channels = parse(args)
+
+    # figure out the desired PWM values
+    multi_pwm(answers, channels)
+
+    if interactive: # Wait on exit, in case user invoked us by clicking an icon
+        print('Press Enter to exit:')
+        input_text()
+
+
+def parse(args):
+    """Get the ramp's parameters from the command line args,
+    or ask the user for any which are missing.
+    Returns (answers, channels).
+    """
     cli_answers = []
     global max_pwm, max_pwms, dyn_pwm
     pwm_arg = str(max_pwm)
@@ -118,12 +133,7 @@ def main(args):
             if channels[j].type == '7135':
                 channel.prev_lm += channels[j].lm_max
 
-    # figure out the desired PWM values
-    multi_pwm(answers, channels)
-
-    if interactive: # Wait on exit, in case user invoked us by clicking an icon
-        print('Press Enter to exit:')
-        input_text()
+    return answers, channels
 
 
 class Empty:
@@ -131,6 +141,15 @@ class Empty:
 
 
 def multi_pwm(answers, channels):
+    goals = calc_pwm(answers, channels)
+    show_pwm(answers, channels, goals)
+
+
+def calc_pwm(answers, channels):
+    """Figure out each channel's PWM value for each level.
+    Results go into channel.modes (and max_pwms, for dynamic PWM).
+    Returns the goal for each level, as (visual, lumens).
+    """
     lm_min = channels[0].lm_min
     # figure out the highest mode
     lm_max = max([(c.lm_max+c.prev_lm) for c in channels])
@@ -214,6 +233,10 @@ def multi_pwm(answers, channels):
             else:
                 channel.modes.append(0)
 
+    return goals
+
+
+def show_pwm(answers, channels, goals):
     # Show individual levels in detail
     prev_ratios = [0.0] * len(channels)
     for i in range(answers.num_levels):
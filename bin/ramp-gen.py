@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+
+"""ramp-gen.py: Generate ramp tables from a build target's RAMP_SPEC.
+
+Usage: cpp -dM ... | ramp-gen.py levels.h [report.txt]
+
+Reads a macro dump (from "cpp -dM") of a build target, and writes a
+header with its PWM1_LEVELS through PWMn_LEVELS, plus PWM_TOPS for
+dynamic PWM, calculated by level_calc.py.  bin/build.sh runs this
+automatically for targets which define RAMP_SPEC.
+
+RAMP_SPEC is a string with the same args level_calc.py takes on the
+command line, so a cfg file can say:
+
+  #define RAMP_SPEC "5.7895 2 150 7135 1 0.1 130 FET 1 10 3000 --pwm dyn:74:4096:255:3"
+
+... instead of pasting the tables that command prints.  One extra
+option, "--fast", means the PWM timer is in fast mode instead of
+phase-correct.
+
+The report lists each level's goal and predicted lumens, which
+channel is doing the work, its PWM frequency (from F_CPU, the PWM TOP
+value, and dynamic underclocking), and how far off the rounded PWM
+value is.  "quant" is the worst error rounding can cause at that level,
+which is +/- half a PWM step.
+
+The ramp must get brighter at every level.  If a level's predicted
+output is lower than the level below it, the build fails.  Levels
+which don't get any brighter, or which take a much bigger step than
+the ramp shape asks for, get a warning.
+"""
+
+import contextlib
+import io
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import level_calc
+
+# warn about steps this many times bigger than the ideal step size
+BIG_STEP = 2.0
+
+
+def main(args):
+    if not args:
+        print(__doc__)
+        return 1
+
+    macros = {}
+    for line in sys.stdin:
+        parts = line.split(None, 2)
+        if len(parts) == 3 and parts[0] == '#define':
+            macros[parts[1]] = parts[2].strip()
+        elif len(parts) == 2 and parts[0] == '#define':
+            macros[parts[1]] = ''
+
+    if 'RAMP_SPEC' not in macros:
+        return fail('no RAMP_SPEC')
+    spec = macros['RAMP_SPEC'].strip('"').split()
+    fast = '--fast' in spec
+    spec = [a for a in spec if a != '--fast']
+
+    # no stdin left, so level_calc can't fall back to asking questions
+    # (and its prompts shouldn't end up in the build log)
+    try:
+        with contextlib.redirect_stdout(io.StringIO()):
+            answers, channels = level_calc.parse(spec)
+    except EOFError:
+        return fail('RAMP_SPEC is missing some values')
+    except ValueError as e:
+        return fail('bad RAMP_SPEC: %s' % (e,))
+    goals = level_calc.calc_pwm(answers, channels)
+
+    levels = predict(answers, channels, goals)
+    problems = check(answers, levels)
+
+    with open(args[0], 'w') as fp:
+        fp.write(header(macros['RAMP_SPEC'], channels))
+    if len(args) > 1:
+        with open(args[1], 'w') as fp:
+            fp.write(report(macros, answers, channels, levels, fast, problems))
+
+    errors = [p for p in problems if p[1] == 'ERROR']
+    worst = max(levels, key=lambda l: abs(l.err))
+    print('ramp-gen: %i levels, %i channels, worst rounding error %+.2f%% at level %i, %i warnings, %i errors' % (
+        answers.num_levels, len(channels), worst.err, worst.num,
+        len(problems) - len(errors), len(errors)))
+    for num, kind, text in problems:
+        print('ramp-gen: %s: level %i: %s' % (kind, num, text))
+    if errors:
+        return 1
+    return 0
+
+
+def fail(reason):
+    print('ramp-gen: %s' % (reason,))
+    return 1
+
+
+class Level:
+    pass
+
+
+def predict(answers, channels, goals):
+    """Work backward from the rounded PWM values to the output they give,
+    using the same model level_calc uses to choose them."""
+    levels = []
+    for i in range(answers.num_levels):
+        l = Level()
+        l.num = i + 1
+        l.goal_vis, l.goal_lm = goals[i]
+        l.top = level_calc.max_pwms[i]
+        l.pwms = [int(round(c.modes[i])) for c in channels]
+        rise_time = level_calc.calc_rise_time(i, answers)
+
+        # the highest channel which is on does the work
+        l.ch = max([c for c in range(len(channels)) if l.pwms[c]] or [0])
+        chan = channels[l.ch]
+        if chan.type == 'FET':
+            lm_avail = chan.lm_max - chan.prev_lm - chan.lm_min
+        else:
+            lm_avail = chan.lm_max - chan.lm_min
+        pwm_avail = l.top - chan.pwm_min - rise_time
+        lm_per_pwm = lm_avail / pwm_avail
+
+        if l.pwms[l.ch]:
+            l.lm = chan.prev_lm + chan.lm_min \
+                + (lm_per_pwm * (l.pwms[l.ch] - chan.pwm_min - rise_time))
+        else:
+            l.lm = 0.0
+        l.err = 100.0 * (l.lm - l.goal_lm) / l.goal_lm
+        l.quant = 100.0 * (0.5 * lm_per_pwm) / l.goal_lm
+        levels.append(l)
+    return levels
+
+
+def check(answers, levels):
+    """Make sure the ramp is smooth."""
+    problems = []
+    if len(levels) < 2:
+        return problems
+    step = levels[1].goal_vis - levels[0].goal_vis
+    for prev, l in zip(levels, levels[1:]):
+        if l.lm < prev.lm:
+            problems.append((l.num, 'ERROR', 'dimmer than level %i (%.3f lm < %.3f lm)' % (
+                prev.num, l.lm, prev.lm)))
+        elif l.lm == prev.lm:
+            problems.append((l.num, 'WARN', 'same as level %i' % (prev.num,)))
+        elif l.pwms[l.ch] and prev.pwms[prev.ch]:
+            vis = level_calc.invpower(l.lm) - level_calc.invpower(prev.lm)
+            if vis > (step * BIG_STEP):
+                problems.append((l.num, 'WARN', 'big step, %.1fx normal size' % (vis / step,)))
+    return problems
+
+
+def header(spec, channels):
+    lines = [
+        '// ramp tables, generated by ramp-gen.py',
+        '// RAMP_SPEC %s' % (spec,),
+        ]
+    for cnum, channel in enumerate(channels):
+        lines.append('#define PWM%i_LEVELS %s' % (
+            cnum + 1, ','.join(str(int(round(x))) for x in channel.modes)))
+    if level_calc.dyn_pwm:
+        lines.append('#define PWM_TOPS %s' % (
+            ','.join(str(x) for x in level_calc.max_pwms)))
+    return '\n'.join(lines) + '\n'
+
+
+def pwm_hz(macros, level, fast):
+    """How fast the PWM runs at this level, in Hz."""
+    hz = float(macros.get('F_CPU', '8000000').rstrip('UL'))
+    # delta-sigma modulation scales the levels, but the timer is 8-bit
+    top = 255 if 'USE_DELTA_SIGMA' in macros else level.top
+    if 'USE_DYNAMIC_UNDERCLOCKING' in macros:
+        quarter = macros.get('QUARTERSPEED_LEVEL', '').rstrip('UL')
+        half = macros.get('HALFSPEED_LEVEL', '').rstrip('UL')
+        if quarter.isdigit() and (level.num < int(quarter)):
+            hz /= 4
+        elif half.isdigit() and (level.num < int(half)):
+            hz /= 2
+    if fast:
+        return hz / (top + 1)
+    return hz / (2 * top)
+
+
+def report(macros, answers, channels, levels, fast, problems):
+    out = []
+    out.append('RAMP_SPEC %s' % (macros['RAMP_SPEC'],))
+    out.append('shape %s, %i levels, %s PWM, F_CPU %s' % (
+        answers.ramp_shape, answers.num_levels,
+        'fast' if fast else 'phase-correct', macros.get('F_CPU', '?')))
+    for cnum, c in enumerate(channels):
+        out.append('channel %i: %s, %.2f to %.2f lm, lowest PWM %i' % (
+            cnum + 1, c.type, c.lm_min, c.lm_max, c.pwm_min))
+    out.append('')
+    out.append('%5s %11s %11s %8s %7s %3s %10s  %s' % (
+        'level', 'goal lm', 'lm', 'error', 'quant', 'ch', 'PWM Hz', 'PWM / TOP'))
+    notes = dict((num, '%s: %s' % (kind, text)) for num, kind, text in problems)
+    for l in levels:
+        line = '%5i %11.3f %11.3f %+7.2f%% %6.2f%% %3i %10.0f  %s / %i' % (
+            l.num, l.goal_lm, l.lm, l.err, l.quant, l.ch + 1,
+            pwm_hz(macros, l, fast), ','.join(str(p) for p in l.pwms), l.top)
+        if l.num in notes:
+            line += '  ' + notes[l.num]
+        out.append(line)
+    return '\n'.join(out) + '\n'
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+"""ramp-pack.py: Pack 8-bit ramp tables into a smaller format.
+
+Usage: cpp -dM ... | ramp-pack.py > packed.h
+
+Reads a macro dump (from "cpp -dM") of a build target, and prints a
+header with packed versions of its PWM1_LEVELS through PWM5_LEVELS, as
+PWM1_PACKED through PWM5_PACKED, plus PWM_PACKED to say it worked.
+bin/build.sh runs this automatically for targets which define
+USE_PACKED_RAMPS, and fsm-ramping.h uses the result.
+
+Tables are only packed when all of them fit in 8 bits.  Otherwise the
+header is empty, and the build uses the regular tables.
+
+Packed format:
+  A list of segments, each starting with a header byte.  The top two
+  bits are the segment type, and the low 6 bits are its length minus 1,
+  so a segment holds 1 to 64 ramp levels.
+    0x00  LIT:    raw values, one byte each
+    0x40  RUN:    one value, repeated for the whole segment
+    0x80  DELTA:  first value, then 4-bit steps upward from each level
+                  to the next, two per byte (low nibble first)
+  ramp_get() in fsm-ramping.c decodes it.
+"""
+
+import sys
+
+LIT, RUN, DELTA = 0x00, 0x40, 0x80
+MAX_LEN = 64
+TABLES = ['PWM%i' % i for i in range(1, 6)]
+
+
+def main(args):
+    macros = {}
+    for line in sys.stdin:
+        parts = line.split(None, 2)
+        if len(parts) == 3 and parts[0] == '#define':
+            macros[parts[1]] = parts[2].strip()
+
+    tables = {}
+    for name in TABLES:
+        key = name + '_LEVELS'
+        if key not in macros:
+            continue
+        try:
+            values = [int(x, 0) for x in macros[key].split(',')]
+        except ValueError:
+            return skip('%s is not a plain list of numbers' % key)
+        if min(values) < 0 or max(values) > 255:
+            return skip('%s does not fit in 8 bits' % key)
+        tables[name] = values
+
+    if not tables:
+        return skip('no ramp tables')
+
+    print('// packed ramp tables, generated by ramp-pack.py')
+    print('#define PWM_PACKED')
+    for name in TABLES:
+        if name not in tables:
+            continue
+        values = tables[name]
+        packed = pack(values)
+        assert unpack(packed, len(values)) == values
+        print('// %s: %i bytes, was %i' % (name, len(packed), len(values)))
+        print('#define %s_PACKED %s' % (name, ','.join(str(x) for x in packed)))
+
+
+def skip(reason):
+    print('// ramp tables not packed: %s' % (reason,))
+
+
+def segment(values, start, length):
+    """Cheapest encoding of values[start:start+length] as one segment,
+    as (size, bytes), or None if it can't be one segment."""
+    seg = values[start:start+length]
+    hdr = length - 1
+    options = [(1 + length, [LIT | hdr] + seg)]
+    if min(seg) == max(seg):
+        options.append((2, [RUN | hdr, seg[0]]))
+    steps = [b - a for a, b in zip(seg, seg[1:])]
+    if all(0 <= s <= 15 for s in steps):
+        nibbles = steps + [0] * (len(steps) % 2)
+        data = [lo | (hi << 4) for lo, hi in zip(nibbles[0::2], nibbles[1::2])]
+        options.append((2 + len(data), [DELTA | hdr, seg[0]] + data))
+    return min(options, key=lambda o: o[0])
+
+
+def pack(values):
+    """Split the table into the smallest set of segments."""
+    n = len(values)
+    # best[i] = (size, bytes) for values[i:]
+    best = [None] * n + [(0, [])]
+    for i in range(n - 1, -1, -1):
+        for length in range(1, min(MAX_LEN, n - i) + 1):
+            size, data = segment(values, i, length)
+            rest = best[i + length]
+            if (best[i] is None) or (size + rest[0] < best[i][0]):
+                best[i] = (size + rest[0], data + rest[1])
+    return best[0][1]
+
+
+def unpack(packed, count):
+    """Decode every level the same way ramp_get() does, to check the result."""
+    return [get(packed, level) for level in range(count)]
+
+
+def get(packed, level):
+    p = 0
+    while True:
+        hdr = packed[p]
+        p += 1
+        length = (hdr & 0x3f) + 1
+        kind = hdr & 0xc0
+        if level < length:
+            if kind == LIT:
+                return packed[p + level]
+            value = packed[p]
+            p += 1
+            if kind == RUN:
+                return value
+            for i in range(level):
+                b = packed[p + (i >> 1)]
+                value += (b >> 4) if (i & 1) else (b & 0x0f)
+            return value
+        level -= length
+        if kind == LIT:
+            p += length
+        elif kind == RUN:
+            p += 1
+        else:
+            p += 1 + (length >> 1)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+
+"""size-report.py: Flash / RAM / EEPROM usage table for a set of builds.
+
+Usage: size-report.py [options] ATTINY:file.elf [ATTINY:file.elf ...]
+
+Options:
+  --baseline FILE   compare against sizes saved earlier with --save
+  --save FILE       save these sizes (and per-function sizes) to FILE
+                    (targets already in FILE but not built now are kept)
+  --functions N     show up to N per-function changes for each target
+                    which grew or shrank (default 8), or with no
+                    baseline, the N biggest functions in each target
+
+Prints one line per target, with whitespace-separated columns:
+  target mcu flash data bss eeprom flash_free ram_free flash_delta ram_delta
+Lines starting with "#" are comments, so the table is easy to parse.
+Per-function details follow the table, on lines starting with "##".
+Sizes are in bytes.  Flash includes .data because its initial values
+are stored in flash.  RAM does not include the stack.
+"""
+
+import json
+import os
+import subprocess
+import sys
+
+AVR_SIZE = os.environ.get('AVR_SIZE', 'avr-size')
+AVR_NM = os.environ.get('AVR_NM', 'avr-nm')
+
+# flash, RAM, EEPROM bytes per MCU
+mcu_limits = {
+    '13':   (1024, 64, 64),
+    '25':   (2048, 128, 128),
+    '45':   (4096, 256, 256),
+    '85':   (8192, 512, 512),
+    '1634': (16384, 1024, 256),
+    '416':  (4096, 256, 128),
+    '417':  (4096, 256, 128),
+    '816':  (8192, 512, 128),
+    '817':  (8192, 512, 128),
+    '1616': (16384, 2048, 256),
+    '1617': (16384, 2048, 256),
+    '3216': (32768, 2048, 256),
+    '3217': (32768, 2048, 256),
+}
+
+
+def main(args):
+    baseline_path = None
+    save_path = None
+    num_functions = 8
+    builds = []
+
+    i = 0
+    while i < len(args):
+        a = args[i]
+        if a in ('--baseline',):
+            i += 1
+            baseline_path = args[i]
+        elif a in ('--save',):
+            i += 1
+            save_path = args[i]
+        elif a in ('--functions',):
+            i += 1
+            num_functions = int(args[i])
+        elif a in ('-h', '--help'):
+            print(__doc__.strip())
+            return 0
+        elif ':' in a:
+            attiny, path = a.split(':', 1)
+            builds.append((attiny, path))
+        else:
+            print('unrecognized option: "%s"' % (a,))
+            return 1
+        i += 1
+
+    if not builds:
+        print(__doc__.strip())
+        return 1
+
+    targets = {}
+    for attiny, path in builds:
+        t = measure(attiny, path)
+        if t:
+            targets[t['name']] = t
+
+    baseline = {}
+    if baseline_path and os.path.exists(baseline_path):
+        with open(baseline_path) as fp:
+            baseline = json.load(fp)
+
+    print_table(targets, baseline)
+    print_functions(targets, baseline, num_functions)
+
+    if save_path:
+        saved = {}
+        if os.path.exists(save_path):
+            with open(save_path) as fp:
+                saved = json.load(fp)
+        saved.update(targets)
+        with open(save_path, 'w') as fp:
+            json.dump(saved, fp, indent=1, sort_keys=True)
+        print('# saved %i targets to %s' % (len(targets), save_path))
+
+    return 0
+
+
+def measure(attiny, path):
+    """Get section and symbol sizes from one .elf file."""
+    if not os.path.exists(path):
+        print('# missing: %s' % (path,))
+        return None
+
+    name = os.path.basename(path)
+    if name.endswith('.elf'):
+        name = name[:-4]
+
+    sections = {}
+    out = run([AVR_SIZE, '-A', path])
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[0].startswith('.') and parts[1].isdigit():
+            sections[parts[0]] = int(parts[1])
+
+    text = sections.get('.text', 0)
+    rodata = sections.get('.rodata', 0)  # only on avrxmega3 (1-series)
+    data = sections.get('.data', 0)
+    bss = sections.get('.bss', 0) + sections.get('.noinit', 0)
+    eeprom = sections.get('.eeprom', 0)
+
+    flash_max, ram_max, eeprom_max = mcu_limits.get(attiny, (0, 0, 0))
+    flash = text + rodata + data
+    ram = data + bss
+
+    # per-symbol sizes, for finding what grew
+    symbols = {}
+    out = run([AVR_NM, '--size-sort', '-S', '-t', 'd', path])
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 4 and parts[2] in 'TtWwDdBbRrVv':
+            symbols[parts[3]] = int(parts[1])
+
+    return {
+        'name': name,
+        'mcu': attiny,
+        'flash': flash,
+        'data': data,
+        'bss': bss,
+        'eeprom': eeprom,
+        'flash_free': flash_max - flash,
+        'ram_free': ram_max - ram,
+        'eeprom_free': eeprom_max - eeprom,
+        'symbols': symbols,
+    }
+
+
+def run(cmd):
+    try:
+        return subprocess.check_output(cmd, universal_newlines=True)
+    except (OSError, subprocess.CalledProcessError) as e:
+        print('# %s failed: %s' % (cmd[0], e))
+        return ''
+
+
+def signed(num):
+    if num is None:
+        return '-'
+    return '%+i' % (num,)
+
+
+def print_table(targets, baseline):
+    fmt = '%-32s %5s %6s %5s %5s %6s %10s %8s %11s %9s'
+    print(fmt % ('# target', 'mcu', 'flash', 'data', 'bss', 'eeprom',
+                 'flash_free', 'ram_free', 'flash_delta', 'ram_delta'))
+
+    # tightest targets first
+    order = sorted(targets.values(), key=lambda t: (t['flash_free'], t['name']))
+    for t in order:
+        flash_delta = ram_delta = None
+        b = baseline.get(t['name'])
+        if b:
+            flash_delta = t['flash'] - b['flash']
+            ram_delta = (t['data'] + t['bss']) - (b['data'] + b['bss'])
+        print(fmt % (t['name'], t['mcu'], t['flash'], t['data'], t['bss'],
+                     t['eeprom'], t['flash_free'], t['ram_free'],
+                     signed(flash_delta), signed(ram_delta)))
+
+    full = [t['name'] for t in order
+            if min(t['flash_free'], t['ram_free'], t['eeprom_free']) < 0]
+    if full:
+        print('# TOO BIG: %s' % (' '.join(full),))
+
+
+def print_functions(targets, baseline, num):
+    if num <= 0:
+        return
+
+    for name in sorted(targets):
+        t = targets[name]
+        b = baseline.get(name)
+
+        if not baseline:
+            # no baseline: just list the biggest things
+            biggest = sorted(t['symbols'].items(), key=lambda x: (-x[1], x[0]))
+            print('## %s: biggest symbols' % (name,))
+            for sym, size in biggest[:num]:
+                print('##   %6i  %s' % (size, sym))
+            continue
+
+        if not b or b['flash'] == t['flash'] and b['bss'] == t['bss']:
+            continue
+
+        old = b.get('symbols', {})
+        new = t['symbols']
+        changes = []
+        for sym in set(old) | set(new):
+            diff = new.get(sym, 0) - old.get(sym, 0)
+            if diff:
+                changes.append((-abs(diff), sym, diff, new.get(sym, 0)))
+        changes.sort()
+
+        print('## %s: flash %s, symbols changed:' % (
+              name, signed(t['flash'] - b['flash'])))
+        for _, sym, diff, size in changes[:num]:
+            print('##   %6s  %6i  %s' % (signed(diff), size, sym))
+        if len(changes) > num:
+            print('##   ... and %i more' % (len(changes) - num,))
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))